@@ -5,6 +5,12 @@
 *   NOTES:
 *       Memory footprint of this library is aproximately xxx bytes (global variables)
 *
+*       Pipeline state (log settings, timer, file sync mode, steps journal, event loop and returned
+*       strings) is kept in a context (micContext), every thread uses a default context unless
+*       another one is set with micSetCurrentContext(), so independent pipelines can run side by side
+*       in one process; worker pool, admission control, learned commands data, system topology and
+*       interned paths are shared by all contexts
+*
 *   CONFIGURATION:
 *
 *   #define MIC_IMPLEMENTATION
@@ -15,8 +21,21 @@
 *   #define MIC_xxxx
 *       If defined, the library can...
 *
+*   #define MIC_COMMANDS_HISTORY_FILE
+*       File used to store learned commands data (peak memory, duration) and steps durations between runs,
+*       ".mic_commands" by default.
+*
+*   #define MIC_JOURNAL_FILE
+*       File used to record completed process steps and their outputs fingerprints, to resume
+*       a failed run from first incomplete step (micSetResumeMode()), ".mic_journal" by default.
+*
+*   #define MIC_DISABLE_IO_URING
+*       If defined, io_uring is not used on Linux for batched file queries (micGetFileInfoBatch()),
+*       a worker threads pool is used instead (same as other platforms), and asynchronous file
+*       operations (micLoadFileDataAsync(), micSaveFileDataAsync()) run synchronously.
+*
 *   DEPENDENCIES:
-*       None.
+*       None. On POSIX platforms some functions use threads, it could require linking with -lpthread.
 *
 *   CONTRIBUTORS:
 *       Ramon Santamaria:   Main developer, maintainer
@@ -111,10 +130,126 @@ typedef enum {
     MIC_ENV_INFO_OS_VERSION,
     MIC_ENV_INFO_PLATFORM,
     MIC_ENV_INFO_MACHINE_NAME,
+    MIC_ENV_INFO_CPU_LOGICAL_CORES,     // Logical cores available to the process (affinity mask)
+    MIC_ENV_INFO_CPU_PHYSICAL_CORES,    // Physical cores (without SMT siblings)
+    MIC_ENV_INFO_CPU_QUOTA,             // CPU quota in cores (cgroup), 0 if not limited
+    MIC_ENV_INFO_CPU_CORES_EFFECTIVE,   // Cores that can be used in parallel (logical cores limited by quota)
+    MIC_ENV_INFO_MEMORY_TOTAL,          // Physical memory in bytes
+    MIC_ENV_INFO_MEMORY_LIMIT,          // Memory limit in bytes (cgroup), 0 if not limited
+    MIC_ENV_INFO_NUMA_NODES,            // NUMA nodes count
+    MIC_ENV_INFO_CACHE_L1,              // L1 data cache size in bytes (per core)
+    MIC_ENV_INFO_CACHE_L2,              // L2 cache size in bytes
+    MIC_ENV_INFO_CACHE_L3,              // L3 cache size in bytes
+    MIC_ENV_INFO_SIMD,                  // SIMD instruction sets available, space separated
 } micEnvInfo;
 
+// SIMD instruction sets flags
+typedef enum {
+    MIC_SIMD_SSE2       = 0x0001,
+    MIC_SIMD_SSSE3      = 0x0002,
+    MIC_SIMD_SSE41      = 0x0004,
+    MIC_SIMD_SSE42      = 0x0008,
+    MIC_SIMD_AVX        = 0x0010,
+    MIC_SIMD_AVX2       = 0x0020,
+    MIC_SIMD_AVX512F    = 0x0040,
+    MIC_SIMD_NEON       = 0x0100,
+} micSimdFlags;
+
+// System hardware topology, filled once and cached by micGetSystemTopology()
+typedef struct micSystemTopology {
+    int logicalCores;               // Logical cores available to the process (affinity mask)
+    int physicalCores;              // Physical cores (without SMT siblings)
+    float cpuQuota;                 // CPU quota in cores (cgroup cpu.max), 0.0f if not limited
+    int effectiveCores;             // Cores that can be used in parallel: min(logicalCores, ceil(cpuQuota))
+    long long memoryTotal;          // Physical memory in bytes
+    long long memoryLimit;          // Memory limit in bytes (cgroup memory.max), 0 if not limited
+    int numaNodes;                  // NUMA nodes count
+    int cacheL1;                    // L1 data cache size in bytes
+    int cacheL2;                    // L2 cache size in bytes
+    int cacheL3;                    // L3 cache size in bytes
+    unsigned int simd;              // SIMD instruction sets available: micSimdFlags
+} micSystemTopology;
+
+// File sync mode (durability of files saved with micSaveFileData()/micSaveFileText())
+typedef enum {
+    MIC_FILE_SYNC_NONE = 0,     // No explicit sync, data reaches storage when the OS decides (fastest, not crash-safe)
+    MIC_FILE_SYNC_IMMEDIATE,    // Sync every file (and its directory entry) as it is saved
+    MIC_FILE_SYNC_BATCHED,      // Sync all files saved during a step with a single barrier at micEndStep() or micSyncFiles()
+} micFileSyncMode;
+
+// File copy flags, for micSetCopyFlags() (micCopyFile(), micCopyDirectory())
+typedef enum {
+    MIC_COPY_SYNC = 1,          // Sync mode: unchanged files (same size and modification time) skipped, changed files updated in place
+    MIC_COPY_DELETE = 2,        // Delete destination files and directories not available in source (micCopyDirectory())
+} micCopyFlags;
+
+// File info time types, for micGetFileInfo()
+typedef enum {
+    MIC_FILE_INFO_TIME_CREATION = 0,    // File creation time (status change time on platforms without birth time)
+    MIC_FILE_INFO_TIME_LAST_ACCESS,     // File last access time
+    MIC_FILE_INFO_TIME_LAST_WRITE,      // File last write (modification) time
+} micFileInfoType;
+
+// File metadata, filled by micGetFileInfoBatch()
+typedef struct micFileInfo {
+    bool available;                 // File exists and metadata could be queried
+    unsigned int mode;              // File type and permissions (st_mode)
+    long long size;                 // File size in bytes
+    long long modTime;              // File last modification time (nanoseconds since epoch)
+    unsigned long long inode;       // File serial number (inode)
+} micFileInfo;
+
+// Hash algorithms
+typedef enum {
+    MIC_HASH_XXH3 = 0,          // XXH3 64-bit: fast, non-cryptographic (8 bytes digest), sequential (one thread per input)
+    MIC_HASH_BLAKE3,            // BLAKE3 256-bit: cryptographic, tree hash (32 bytes digest)
+} micHashType;
+
+// Hash digest
+typedef struct micHash {
+    unsigned char bytes[32];    // Digest bytes, canonical order
+    int size;                   // Digest size in bytes (0 if hash could not be computed)
+} micHash;
+
+// Zip archive entry
+typedef struct micZipEntry {
+    char *name;                 // Entry name (path inside archive, directories end with '/')
+    unsigned int crc32;         // Uncompressed data CRC32
+    int method;                 // Compression method: 0-stored, 8-deflated
+    int flags;                  // General purpose flags (bit 0: encrypted)
+    int mode;                   // Unix permissions (0 if not created on Unix)
+    long long compSize;         // Compressed data size in bytes
+    long long size;             // Uncompressed data size in bytes
+    long long offset;           // Local header offset in archive
+} micZipEntry;
+
+// Zip archive, central directory loaded and indexed by name
+typedef struct micZipArchive {
+    int entryCount;             // Entries count
+    micZipEntry *entries;       // Entries (central directory order)
+
+    char *names;                // Entries names buffer
+    int *index;                 // Entries hash index (entry index + 1, 0: empty slot)
+    int indexSize;              // Entries hash index slots (power of 2)
+    unsigned char *data;        // Archive data (memory mapped)
+    long long dataSize;         // Archive data size in bytes
+} micZipArchive;
+
+// Line reader (opaque), see micOpenLineReader()
+typedef struct micLineReader micLineReader;
+
+// Multi-pattern replacer (opaque), see micLoadReplacer()
+typedef struct micReplacer micReplacer;
+
+// Asynchronous operation (opaque), see micExecuteCommandAsync()
+typedef struct micFuture micFuture;
+
+// Library context (opaque), see micCreateContext()
+typedef struct micContext micContext;
+
 // Callbacks to hook some internal functions
 typedef void (*micTraceLogCallback)(int logLevel, const char *text, va_list args);  // Logging: Redirect trace log messages
+typedef void (*micFutureCallback)(micFuture *future, void *userData);   // Async: Continuation called when future completes
 
 //----------------------------------------------------------------------------------
 // Module Functions Declaration
@@ -124,33 +259,63 @@ typedef void (*micTraceLogCallback)(int logLevel, const char *text, va_list args
 extern "C" {            // Prevents name mangling of functions
 #endif
 
+// Context management (independent pipelines in one process)
+MICAPI micContext *micCreateContext(void);                              // Create library context: log settings, timer, file sync mode, steps journal, event loop
+MICAPI void micDestroyContext(micContext *context);                     // Destroy library context (pending asynchronous operations completed first)
+MICAPI void micSetCurrentContext(micContext *context);                  // Set context used by calling thread (NULL: default context)
+MICAPI micContext *micGetCurrentContext(void);                          // Get context used by calling thread
+
 // Log System
 MICAPI void micTraceLog(int logLevel, const char *text, ...);           // Show trace log messages (LOG_DEBUG, LOG_INFO, LOG_WARNING, LOG_ERROR...)
 MICAPI void micSetTraceLogLevel(int logLevel);                          // Set the current threshold (minimum) log level
 MICAPI void micSetTraceLogCallback(micTraceLogCallback callback);          // Set custom trace log
+MICAPI bool micSetTraceLogFile(const char *fileName);                   // Set trace log file: messages also appended to file, rotated segments compressed (NULL: close)
+MICAPI void micSetTraceLogRotation(long long maxSize, int maxAge, int maxFiles, long long maxTotalSize);  // Set log file rotation: segment size (bytes) and age (seconds), rotated segments kept (count, bytes), 0: no limit
 
 // Environment
 MICAPI void micSetEnvironmentFlags(unsigned int flags);                 // Setup environment config flags
 MICAPI void micSetEnvironmentPath(const char *path);                    // Set environment path (added to system PATH)
 MICAPI const char *micGetEnvironmentInfo(int info);                     // Get environment info: enum micEnvInfo
+MICAPI const micSystemTopology *micGetSystemTopology(void);             // Get system hardware topology (queried once, cached)
 
 // Processes execution
 MICAPI void micBeginProcess(const char *description, int level);        // [!] Begin a new process -> Not sure yet how use this, maybe just for logging...
 MICAPI void micEndProcess(void);                                        // End current process
 MICAPI void micBeginStep(const char *description, int level);           // [!] Begin a new process step -> Not sure yet how use it
 MICAPI void micEndStep(void);                                           // End current step
+MICAPI void micSetResumeMode(bool resume);                              // Set resume mode: steps completed in previous run are skipped (journal, outputs unchanged)
+MICAPI bool micIsStepCompleted(void);                                   // Check if current step was completed in previous run (resume mode), work can be skipped
+MICAPI void micAddStepOutput(const char *fileName);                     // Register current step output file (fingerprint recorded in journal at micEndStep())
 
 MICAPI int micExecuteCommand(const char *command, ...);                 // Execute command line command, parameters passed as additional arguments
+MICAPI int micExecuteCommandList(const char **commands, int count);     // Execute multiple commands concurrently (admission controlled), returns failed commands count
+MICAPI int micExecuteCommandGraph(const char **commands, int count, const int *dependencies, int dependencyCount);  // Execute commands with dependencies (index pairs: before, after), longest remaining path first, returns failed commands count
+MICAPI void micSetJobsLimit(int jobs);                                  // Set maximum commands running concurrently (0: effective CPU cores)
+MICAPI void micSetCommandMemory(const char *program, long long bytes);  // Declare expected peak memory for a program (overrides learned value)
 MICAPI int micExecuteMIC(const char *micFile);                          // Compile and execute another mic file
 //MICAPI void micPrintMessage(const char *message, ...);                // [!] Probably not required -> Just use printf()
 
 // Timming
 MICAPI void micInitTimer(void);                                         // [!] Initialize internal timer -> Support multiple timers?
-MICAPI double micGetTime(void);                                         // Get elapsed time in seconds since micInitTimer()
+MICAPI double micGetTime(void);                                         // Get elapsed time in milliseconds since micInitTimer()
 MICAPI long micGetTimeStamp(void);                                      // Get current date and time (now)
 MICAPI const char *micGetTimeStampString(long timestamp);               // [!] Get timestamp as a string -> format? or just let the user manage it?
 MICAPI int micWaitTime(int milliseconds);                               // Wait (sleep) a specific amount of time
 
+// Asynchronous execution (single-threaded event loop)
+MICAPI micFuture *micExecuteCommandAsync(const char *command, ...);    // Launch command without waiting, future result: command exit code
+MICAPI micFuture *micWaitTimeAsync(int milliseconds);                  // Start a timer without waiting, future result: 0
+MICAPI micFuture *micLoadFileDataAsync(const char *fileName);          // Load file data without waiting, future result: 0 on success (data: micGetFutureData())
+MICAPI micFuture *micSaveFileDataAsync(const char *fileName, void *data, unsigned int bytesToWrite); // Save data to file without waiting (data must stay valid), future result: 0 on success
+MICAPI void micThenFuture(micFuture *future, micFutureCallback callback, void *userData);   // Attach continuation, called from event loop when future completes
+MICAPI int micAwaitFuture(micFuture *future);                           // Run event loop until future completes, returns future result
+MICAPI int micAwaitFutureList(micFuture **futures, int count);          // Run event loop until all futures complete, returns failed futures count
+MICAPI bool micIsFutureReady(micFuture *future);                        // Check if future is completed
+MICAPI int micGetFutureResult(micFuture *future);                       // Get completed future result (-1 if pending)
+MICAPI unsigned char *micGetFutureData(micFuture *future, unsigned int *size);  // Take loaded file data from future (must be freed with micUnloadFileData())
+MICAPI void micUnloadFuture(micFuture *future);                         // Unload future (pending operation continues, future freed when completed)
+MICAPI int micPollEvents(int timeout);                                  // Process ready events, waiting up to timeout ms (-1: until one), returns futures completed
+
 // File system: Edition
 MICAPI int micCreateFile(const char *fileName);                           // Create an empty file, useful for further filling
 MICAPI int micDeleteFile(const char *fileName);                         // Delete an existing file
@@ -163,6 +328,7 @@ MICAPI int micDeleteDirectory(const char *dirPath);                     // Delet
 MICAPI int micRenameDirectory(const char *dirPath);                     // Rename an existing directory
 MICAPI int micCopyDirectory(const char *srcDirPath, const char *dstDirPath);    // Copy an existing directory to a new path
 MICAPI int micMoveDirectory(const char *srcDirPath, const char *dstDirPath);    // Move an existing directory to a new path
+MICAPI void micSetCopyFlags(unsigned int flags);                        // Set copy behaviour for micCopyFile()/micCopyDirectory(): enum micCopyFlags
 
 // File system: Query
 MICAPI bool micIsFileAvailable(const char *fileName);                   // Check if a file exists
@@ -171,22 +337,32 @@ MICAPI bool micIsDirectoryAvailable(const char *dirPath);               // Check
 MICAPI const char *micGetWorkingDirectory(void);                        // Get current working directory (uses static string)
 MICAPI bool micChangeDirectory(const char *dirPath);                    // Change working directory, return true on success
 
-MICAPI int micGetFileSize(const char *fileName);
+MICAPI int micGetFileSize(const char *fileName);                        // Get file size in bytes
 MICAPI long micGetFileModTime(const char *fileName);                    // Get file modification time (last write time)
 MICAPI bool micIsFileExtension(const char *fileName, const char *ext);  // Check file extension (including point: .png, .wav)
 MICAPI const char *micGetFileExtension(const char *fileName);           // Get pointer to extension for a filename string (includes dot: '.png')
 MICAPI const char *micGetFileName(const char *filePath);                // Get pointer to filename for a path string
-MICAPI const char *micGetFileNameWithoutExt(const char *filePath);      // Get filename string without extension (uses static string)
-MICAPI const char *micGetDirectoryPath(const char *filePath);           // Get full path for a given fileName with path (uses static string)
-MICAPI const char *micGetPrevDirectoryPath(const char *dirPath);        // Get previous directory path for a given path (uses static string)
-MICAPI const char *micGetFileFullPath(const char *fileName);            // Get full path for a file
-MICAPI const char *micGetFileRelativePath(const char *fileName, const char *refPath);
-MICAPI long micGetFileInfo(int info)    // MIC_FILE_INFO_TIME_CREATION, MIC_FILE_INFO_TIME_LAST_ACCESS, MIC_FILE_INFO_TIME_LAST_WRITE
+MICAPI const char *micGetFileNameWithoutExt(const char *filePath);      // Get filename string without extension (interned string)
+MICAPI const char *micGetDirectoryPath(const char *filePath);           // Get directory path for a given fileName with path (interned string)
+MICAPI const char *micGetPrevDirectoryPath(const char *dirPath);        // Get previous directory path for a given path (interned string)
+MICAPI const char *micGetFileFullPath(const char *fileName);            // Get full path for a file (interned string)
+MICAPI const char *micGetFileRelativePath(const char *fileName, const char *refPath);  // Get file path relative to another path (interned string)
+MICAPI long micGetFileInfo(const char *fileName, int info);             // Get file time info: enum micFileInfoType
+MICAPI int micGetFileInfoBatch(const char **fileNames, int count, micFileInfo *infos);  // Get metadata for multiple files at once, returns available files count
 
 MICAPI int micGetDirectorySize(const char *dirPath);                    // Get directory byte size (for all files contained)
 MICAPI char **micGetDirectoryFiles(const char *dirPath, int *count);    // Get filenames in a directory path (memory should be freed)
 MICAPI void micClearDirectoryFiles(void);                               // Clear directory files paths buffers (free memory)
 
+// File system: Paths interning (normalized paths stored once, identified by 32-bit ids)
+MICAPI unsigned int micInternPath(const char *path);                    // Normalize and intern path, returns path id (0 if path not valid)
+MICAPI unsigned int micFindPathId(const char *path);                    // Get path id of a path already interned (0 if not interned), path is normalized first
+MICAPI const char *micGetPathString(unsigned int pathId);               // Get interned path string (normalized, valid until micUnloadPaths())
+MICAPI unsigned int micGetPathLength(unsigned int pathId);              // Get interned path length
+MICAPI unsigned int micGetPathParentId(unsigned int pathId);            // Get interned path parent directory id (interned if required)
+MICAPI unsigned int micGetPathCount(void);                              // Get interned paths count
+MICAPI void micUnloadPaths(void);                                       // Unload interned paths (ids and strings not valid anymore)
+
 // String management (no UTF-8 strings, only byte chars)
 // NOTE: Some strings allocate memory internally for returned strings -> REVIEW
 MICAPI int micStringCopy(char *dstStr, const char *srcStr);             // Copy one string to another, returns bytes copied
@@ -207,6 +383,11 @@ MICAPI int micStringToInteger(const char *str);                         // Get i
 MICAPI bool micStringContains(const char *str, const char *contain);    // Check if a string contains another string
 MICAPI bool micStringStartsWith(const char *str, const char *start);    // Check if a string starts with another prefix string
 
+MICAPI micReplacer *micLoadReplacer(const char **keys, const char **values, int count);     // Load multi-pattern replacer (keys compiled once, Aho-Corasick DFA)
+MICAPI void micUnloadReplacer(micReplacer *replacer);                   // Unload multi-pattern replacer
+MICAPI const char *micReplaceText(micReplacer *replacer, const char *text, int *length);    // Replace all keys in text (single pass), returns reused buffer (do not free)
+MICAPI bool micReplaceFile(micReplacer *replacer, const char *srcFileName, const char *dstFileName);  // Replace all keys in a file into another file (streamed), returns true on success
+
 // Misc functions
 MICAPI bool micSaveStorageValue(unsigned int position, int value);      // Save integer value to storage file (to defined position), returns true on success
 MICAPI int micLoadStorageValue(unsigned int position);                  // Load integer value from storage file (from defined position)
@@ -220,13 +401,28 @@ MICAPI bool micSaveFileData(const char *fileName, void *data, unsigned int bytes
 MICAPI char *micLoadFileText(const char *fileName);                     // Load text data from file (read), returns a '\0' terminated string
 MICAPI void micUnloadFileText(char *text);                              // Unload file text data allocated by LoadFileText()
 MICAPI bool micSaveFileText(const char *fileName, char *text);          // Save text data to file (write), string must be '\0' terminated, returns true on success
+MICAPI void micSetFileSyncMode(int mode);                               // Set durability mode for saved files: enum micFileSyncMode
+MICAPI bool micSyncFiles(void);                                         // Sync pending batched file writes to storage (single barrier), returns true on success
+MICAPI micLineReader *micOpenLineReader(const char *fileName);          // Open text file for line by line reading (constant memory, gzip supported)
+MICAPI const char *micReadLine(micLineReader *reader, int *length);     // Read next line (not '\0' terminated, no line ending), returns NULL at end of file
+MICAPI void micCloseLineReader(micLineReader *reader);                  // Close line reader
 
 MICAPI int micZipFile(const char *srcFileName, const char *dstFileName);    // Compress file into a .zip
 MICAPI int micZipDirectory(const char *srcPath, const char *dstFileName);   // Compress directory into a .zip
+MICAPI int micUnzipFile(const char *srcFileName, const char *dstPath);      // Extract .zip into a directory (parallel), returns entries extracted
+MICAPI micZipArchive micLoadZip(const char *fileName);                      // Load .zip central directory for random access (memory mapped)
+MICAPI void micUnloadZip(micZipArchive zip);                                // Unload .zip archive
+MICAPI int micGetZipEntryIndex(micZipArchive zip, const char *name);        // Get .zip entry index by name, returns -1 if not found
+MICAPI unsigned char *micLoadZipEntryData(micZipArchive zip, const char *name, unsigned int *dataSize);  // Load .zip entry data by name (memory must be freed)
 
 MICAPI unsigned char *micCompressData(unsigned char *data, int dataLength, int *compDataLength);        // Compress data (DEFLATE algorithm)
 MICAPI unsigned char *micDecompressData(unsigned char *compData, int compDataLength, int *dataLength);  // Decompress data (DEFLATE algorithm)
 
+MICAPI micHash micHashData(const void *data, long long size, int type);                 // Compute data hash: enum micHashType (multi-threaded for big data, BLAKE3)
+MICAPI micHash micHashFile(const char *fileName, int type);                             // Compute file hash: enum micHashType (memory mapped, multi-threaded)
+MICAPI int micHashFileList(const char **fileNames, int count, int type, micHash *hashes);    // Compute multiple files hashes at once, returns files hashed count
+MICAPI const char *micHashToString(micHash hash);                                       // Get hash digest as hexadecimal string (uses static string)
+
 #ifdef __cplusplus
 }
 #endif
@@ -242,11 +438,19 @@ MICAPI unsigned char *micDecompressData(unsigned char *compData, int compDataLen
 
 #if defined(MIC_IMPLEMENTATION)
 
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+    #define _GNU_SOURCE             // Required for: GNU extensions, if no other system header was included before
+#endif
+
 #include <stdio.h>
 #include <stdlib.h>                 // Required for: setenv()
 #include <math.h>                   // Required for: sinf(), cosf(), sqrtf()
 
 #include <unistd.h>                 // Required for: execv()
+#include <string.h>                 // Required for: strlen(), strrchr(), memcpy()
+#include <errno.h>                  // Required for: errno
+#include <stdint.h>                 // Required for: uintptr_t
+#include <time.h>                   // Required for: time(), timespec_get(), clock_gettime(), localtime_r()
 
 #include <sys/stat.h>
 #include <sys/types.h>
@@ -256,13 +460,40 @@ MICAPI unsigned char *micDecompressData(unsigned char *compData, int compDataLen
     #include <direct.h>             // Required for: _getch(), _chdir()
     #define GETCWD _getcwd          // NOTE: MSDN recommends not to use getcwd(), chdir()
     #define CHDIR _chdir
-    #include <io.h>                 // Required for: _access() [Used in FileExists()]
+    #include <io.h>                 // Required for: _access() [Used in FileExists()], _commit(), _findfirst()
+    #include <sys/utime.h>          // Required for: _utime()
+    #if defined(_MSC_VER)
+        #include <intrin.h>         // Required for: _InterlockedIncrement()
+    #endif
 #else
     #include <unistd.h>             // Required for: getch(), chdir() (POSIX), access()
+    #include <fcntl.h>              // Required for: open(), O_TMPFILE, linkat()
+    #include <sys/mman.h>           // Required for: mmap(), munmap(), madvise()
+    #include <pthread.h>            // Required for: pthread_create(), pthread_join()
+    #include <sys/utsname.h>        // Required for: uname()
+    #include <sys/wait.h>           // Required for: WIFEXITED(), WEXITSTATUS()
+    #include <sys/resource.h>       // Required for: wait4(), struct rusage
+    #include <spawn.h>              // Required for: posix_spawn()
+    #include <dirent.h>             // Required for: opendir(), readdir()
+    extern char **environ;          // Required for: posix_spawn() environment
     #define GETCWD getcwd
     #define CHDIR chdir
 #endif
 
+#if defined(__linux__)
+    #define FDATASYNC fdatasync     // Sync file data (and size), skipping unneeded metadata
+    #include <sys/epoll.h>          // Required for: epoll_create1(), epoll_ctl(), epoll_wait()
+    #include <sys/timerfd.h>        // Required for: timerfd_create(), timerfd_settime()
+    #include <sys/eventfd.h>        // Required for: eventfd() (io_uring completions notification)
+    #include <sys/syscall.h>        // Required for: syscall(), __NR_pidfd_open, SYS_syncfs, SYS_sched_getaffinity
+    #define SYNCFS(fd) syscall(SYS_syncfs, fd)  // Sync filesystem containing fd (syncfs() only declared with _GNU_SOURCE)
+    #if !defined(O_TMPFILE) && defined(__O_TMPFILE)
+        #define O_TMPFILE (__O_TMPFILE | O_DIRECTORY)   // Same as glibc definition, hidden without _GNU_SOURCE
+    #endif
+#else
+    #define FDATASYNC fsync         // NOTE: fdatasync() not available on all POSIX platforms (macOS)
+#endif
+
 #if defined(_WIN32)
     #if defined(__cplusplus)
     extern "C" {        // Prevents name mangling of functions
@@ -270,6 +501,11 @@ MICAPI unsigned char *micDecompressData(unsigned char *compData, int compDataLen
     // Functions required to query time on Windows
     int __stdcall QueryPerformanceCounter(unsigned long long int *lpPerformanceCount);
     int __stdcall QueryPerformanceFrequency(unsigned long long int *lpFrequency);
+    // Functions required to replace files atomically on Windows
+    int __stdcall MoveFileExA(const char *lpExistingFileName, const char *lpNewFileName, unsigned long dwFlags);
+    // Functions required to lock shared data on Windows (SRWLOCK: pointer size, zero initialized)
+    void __stdcall AcquireSRWLockExclusive(void **SRWLock);
+    void __stdcall ReleaseSRWLockExclusive(void **SRWLock);
     #if defined(__cplusplus)
     }
     #endif
@@ -286,37 +522,861 @@ MICAPI unsigned char *micDecompressData(unsigned char *compData, int compDataLen
 #if defined(__APPLE__)                  // macOS also defines __MACH__
     #include <mach/clock.h>             // Required for: clock_get_time()
     #include <mach/mach.h>              // Required for: mach_timespec_t
+    #include <sys/sysctl.h>             // Required for: sysctlbyname()
+#endif
+
+#if defined(__x86_64__) || defined(__i386__)
+    #if defined(__GNUC__)
+        #include <cpuid.h>              // Required for: __get_cpuid(), __get_cpuid_count()
+    #elif defined(_MSC_VER)
+        #include <intrin.h>             // Required for: __cpuid(), __cpuidex(), _xgetbv()
+    #endif
+#endif
+
+#if defined(__AVX2__)
+    #include <immintrin.h>              // Required for: AVX2 intrinsics (XXH3 accumulation, line ends search)
+#elif defined(__SSE2__)
+    #include <emmintrin.h>              // Required for: SSE2 intrinsics (XXH3 accumulation, line ends search)
+#endif
+
+#if defined(__linux__) && !defined(MIC_DISABLE_IO_URING) && defined(__has_include)
+    #if __has_include(<linux/io_uring.h>)
+        #include <linux/io_uring.h>     // Required for: io_uring_params, io_uring_sqe, io_uring_cqe
+        #include <linux/stat.h>         // Required for: struct statx, STATX_BASIC_STATS (libc ones need _GNU_SOURCE)
+        #include <sys/syscall.h>        // Required for: syscall(), __NR_io_uring_setup, __NR_io_uring_enter
+        #define MIC_IO_URING_AVAILABLE
+    #endif
 #endif
 
 //----------------------------------------------------------------------------------
 // Defines and Macros
 //----------------------------------------------------------------------------------
-//...
+#ifndef MAX_FILEPATH_LENGTH
+    #define MAX_FILEPATH_LENGTH         4096        // Maximum length for filepaths (Linux PATH_MAX default value)
+#endif
+#ifndef MAX_TRACELOG_MSG_LENGTH
+    #define MAX_TRACELOG_MSG_LENGTH         256     // Max length of one trace-log message
+#endif
+#ifndef MAX_IO_THREADS
+    #define MAX_IO_THREADS                32        // Maximum threads for I/O bound jobs (latency bound, not CPU bound)
+#endif
+#ifndef IO_URING_ENTRIES
+    #define IO_URING_ENTRIES             256        // io_uring submission queue entries (requests in flight)
+#endif
+#ifndef MIC_COMMANDS_HISTORY_FILE
+    #define MIC_COMMANDS_HISTORY_FILE   ".mic_commands"     // Learned commands and steps data between runs
+#endif
+#ifndef MIC_JOURNAL_FILE
+    #define MIC_JOURNAL_FILE            ".mic_journal"      // Completed process steps, for resume mode
+#endif
+#ifndef MEMORY_PRESSURE_LIMIT
+    #define MEMORY_PRESSURE_LIMIT       10.0f       // Memory pressure (PSI some avg10, %) over which new commands are held back
+#endif
+#ifndef CPU_PRESSURE_LIMIT
+    #define CPU_PRESSURE_LIMIT          90.0f       // CPU pressure (PSI some avg10, %) over which new commands are held back
+#endif
+#ifndef MEMORY_ADMISSION_FACTOR
+    #define MEMORY_ADMISSION_FACTOR     0.9f        // Fraction of available memory that commands estimates can claim
+#endif
+#ifndef HASH_BIG_FILE_SIZE
+    #define HASH_BIG_FILE_SIZE   (16*1024*1024)     // BLAKE3 files bigger than this are hashed one after another, on all threads
+#endif
+#ifndef MAX_SYNC_PENDING_TARGETS
+    #define MAX_SYNC_PENDING_TARGETS      16        // Maximum filesystems (Linux) tracked for a batched sync barrier
+#endif
+#ifndef LINE_READER_BUFFER_SIZE
+    #define LINE_READER_BUFFER_SIZE (256*1024)      // Line reader buffer size, longer lines are returned in pieces
+#endif
+#ifndef LINE_READER_RELEASE_SIZE
+    #define LINE_READER_RELEASE_SIZE (16*1024*1024) // Line reader (memory mapped) releases pages every time it reads this size
+#endif
+
+#ifndef LINE_READER_INPUT_SIZE
+    #define LINE_READER_INPUT_SIZE   (64*1024)      // Line reader compressed data buffer size (gzip files)
+#endif
+
+#ifndef REPLACER_CHUNK_SIZE
+    #define REPLACER_CHUNK_SIZE      (64*1024)      // Replacer file data read (and output written) by chunks of this size
+#endif
+
+#ifndef COPY_BLOCK_SIZE
+    #define COPY_BLOCK_SIZE          (64*1024)      // Sync mode: changed files compared (and rewritten) by blocks of this size
+#endif
+#ifndef COPY_DELTA_MIN_SIZE
+    #define COPY_DELTA_MIN_SIZE    (1024*1024)      // Sync mode: changed files of this size or bigger are updated in place (smaller ones copied whole)
+#endif
+
+#ifndef DEFLATE_MAX_CHAIN
+    #define DEFLATE_MAX_CHAIN             64        // Compressor match candidates checked per position (higher: better ratio, slower)
+#endif
+
+#ifndef LOG_FILE_MAX_SIZE
+    #define LOG_FILE_MAX_SIZE  (64*1024*1024)       // Log file default segment size, rotated when reached
+#endif
+#ifndef LOG_FILE_MAX_FILES
+    #define LOG_FILE_MAX_FILES            10        // Log file default rotated segments kept
+#endif
+#ifndef LOG_FILE_PENDING_SIZE
+    #define LOG_FILE_PENDING_SIZE (1024*1024)       // Log file messages kept in memory while a segment is rotated (more are dropped)
+#endif
+#ifndef LOG_FILE_COMPRESS_CHUNK_SIZE
+    #define LOG_FILE_COMPRESS_CHUNK_SIZE (4*1024*1024)  // Log file rotated segments compressed by chunks of this size (one gzip member each)
+#endif
+#ifndef LOG_FILE_LINE_LENGTH
+    #define LOG_FILE_LINE_LENGTH        1024        // Log file line maximum length (longer messages are truncated)
+#endif
+
+#ifndef MAX_LOOP_EVENTS
+    #define MAX_LOOP_EVENTS                64       // Event loop events processed per wait
+#endif
+#ifndef LOOP_POLL_INTERVAL
+    #define LOOP_POLL_INTERVAL             10       // Event loop wait limit (ms) while commands are polled (kernel without pidfd)
+#endif
+#ifndef PATH_STORAGE_BLOCK_SIZE
+    #define PATH_STORAGE_BLOCK_SIZE  (1024*1024)    // Interned paths strings are stored in blocks of this size (never moved)
+#endif
+
+#define INFLATE_WINDOW_SIZE            32768        // DEFLATE history (maximum match distance)
+#define INFLATE_HEADER_INPUT            1024        // Compressed bytes required to decode a block header without stopping (if more data to come)
+#define INFLATE_SYMBOL_INPUT               8        // Compressed bytes required to decode a symbol without stopping (if more data to come)
+#define INFLATE_FAST_INPUT                16        // Compressed bytes required to run the fast decoding loop (8 bytes loaded at once)
+#define INFLATE_FAST_OUTPUT              274        // Output space required to run the fast decoding loop (longest match, plus wide copies overrun)
+#define INFLATE_LENGTH_BITS               11        // Literal/length lookup table bits, longer codes decoded with a subtable
+#define INFLATE_DISTANCE_BITS              8        // Distance lookup table bits, longer codes decoded with a subtable
+#define INFLATE_LENGTH_TABLE_SIZE       2342        // Literal/length lookup table entries, subtables included (worst case for 288 symbols)
+#define INFLATE_DISTANCE_TABLE_SIZE      402        // Distance lookup table entries, subtables included (worst case for 32 symbols)
+
+#define COPY_CHUNK_SIZE     (16*COPY_BLOCK_SIZE)    // File data read (compared) by chunks of this size while copied
+
+#define DEFLATE_WINDOW_SIZE            32768        // DEFLATE history (maximum match distance)
+#define DEFLATE_HASH_BITS                 15        // Compressor hash chains heads: 1 << bits
+#define DEFLATE_NICE_LENGTH              128        // Compressor stops searching once a match this long is found
+#define DEFLATE_GOOD_LENGTH                8        // Compressor searches a quarter of the chain after a match this long (lazy matching)
+#define DEFLATE_LAZY_LENGTH               16        // Compressor takes a match this long without searching a longer one at next position
+#define DEFLATE_BLOCK_SYMBOLS          16384        // Compressor symbols per block (Huffman codes built for every block)
+
+#define PATH_ENTRIES_PAGE_SIZE         65536        // Interned paths entries per page (pages never moved)
+#define PATH_ENTRIES_MAX_PAGES         65536        // Interned paths entries pages (32-bit ids)
+#define PATH_TABLE_INITIAL_SIZE         1024        // Interned paths hash table initial slots
+
+#if defined(_WIN32) && !defined(S_ISDIR)
+    #define S_ISDIR(mode)   (((mode) & S_IFMT) == S_IFDIR)
+    #define S_ISREG(mode)   (((mode) & S_IFMT) == S_IFREG)
+#endif
+
+#if defined(_WIN32)
+    #define IS_PATH_SEPARATOR(c)    (((c) == '/') || ((c) == '\\'))
+#else
+    #define IS_PATH_SEPARATOR(c)    ((c) == '/')
+#endif
+#define TOLOWER_ASCII(c)            ((((c) >= 'A') && ((c) <= 'Z'))? ((c) + 32) : (c))
+
+#if defined(_MSC_VER)
+    #define MIC_THREAD_LOCAL        __declspec(thread)
+    #define MIC_FETCH_INCREMENT(x)  ((unsigned int)_InterlockedIncrement((volatile long *)&(x)) - 1)    // Atomic increment, returns previous value
+#else
+    #define MIC_THREAD_LOCAL        __thread
+    #define MIC_FETCH_INCREMENT(x)  __atomic_fetch_add(&(x), 1, __ATOMIC_RELAXED)      // Atomic increment, returns previous value
+#endif
+#define CTX (*((micCurrentContext != NULL)? micCurrentContext : &micDefaultContext))    // Calling thread current context
 
 //----------------------------------------------------------------------------------
 // Types and Structures Definition (internal)
 //----------------------------------------------------------------------------------
+// Command running, memory reserved for admission control
+typedef struct micRunningCommand {
+    bool active;                    // Slot in use
+    int pid;                        // Process id, 0 while spawning
+    long long estimate;             // Expected peak memory in bytes
+} micRunningCommand;
+
+// Command data, key is a hash of the full command line or of the program name
+typedef struct micCommandStats {
+    unsigned long long key;         // Command line or program name hash
+    long long peakMemory;           // Peak memory (resident set) in bytes
+    double duration;                // Wall-clock duration in milliseconds (recent runs weigh more), 0 if unknown
+    bool declared;                  // Peak memory declared by user (not learned, not saved)
+    char name[64];                  // Program name or command line (truncated), for history file readability
+} micCommandStats;
+
+// Journal step output fingerprint
+typedef struct micJournalOutput {
+    long long size;                 // File size in bytes (-1: output not available)
+    long long modTime;              // File modification time (nanoseconds)
+    unsigned long long inode;       // File serial number
+    char hash[17];                  // File content XXH3 hash (hexadecimal)
+    char *path;                     // File path
+} micJournalOutput;
+
+// Journal step, completed in previous run
+typedef struct micJournalStep {
+    unsigned long long key;         // Step description hash
+    int firstOutput;                // First output in journal outputs
+    int outputCount;                // Outputs count
+    size_t end;                     // Journal size up to this step record end
+} micJournalStep;
+
+// Command graph node (micExecuteCommandGraph())
+typedef struct micGraphNode {
+    const char *command;            // Command line
+    double estimate;                // Expected duration in milliseconds (learned from previous runs)
+    double priority;                // Longest remaining path: expected milliseconds from node start to graph end
+    int pending;                    // Predecessors not finished yet
+    bool blocked;                   // A predecessor failed, command is not executed
+    int gate;                       // Command that delayed node start: predecessor finished last or command freeing a running slot (-1: none)
+    int firstSuccessor;             // First successor in graph successors list
+    int successorCount;             // Successors count
+    int result;                     // Command exit code (-1: not executed)
+    double startTime;               // Command start time (milliseconds)
+    double endTime;                 // Command end time (milliseconds)
+} micGraphNode;
+
+// Command graph execution shared state
+typedef struct micCommandGraph {
+    micGraphNode *nodes;            // Commands
+    int count;                      // Commands count
+    int *successors;                // Successors lists (nodes indices)
+    int *ready;                     // Commands ready to run, predecessors finished
+    int readyCount;                 // Commands ready count
+    int remaining;                  // Commands not finished yet
+    int lastFinished;               // Command finished last (-1: none)
+    bool admitting;                 // A worker is waiting for its command admission
+    double startTime;               // Graph execution start time (milliseconds)
+#if !defined(_WIN32)
+    pthread_mutex_t mutex;          // Graph state access
+    pthread_cond_t condition;       // Signaled when a command finishes
+#endif
+} micCommandGraph;
+
+// Interned path entry, path id is the entry position in entries pages
+typedef struct micPathEntry {
+    const char *path;               // Normalized path ('\0' terminated, in paths storage)
+    unsigned int length;            // Path length
+    unsigned int hash;              // Path hash (kept for hash table growth)
+    unsigned int parent;            // Parent directory path id (0: not computed yet)
+} micPathEntry;
+
+// Log file sink: current segment appended, rotated segments renamed and compressed by a background thread
+// NOTE: Logging thread reaching the limits only switches to next segment, pre-created by background thread
+// (renames and compression never delay a message), without background thread segments are rotated by logging thread
+typedef struct micLogFile {
+    char fileName[MAX_FILEPATH_LENGTH];     // Current segment file name (rotated segments get a time stamp suffix)
+    char nextFileName[MAX_FILEPATH_LENGTH]; // Next segment file name, renamed to file name once previous segment is renamed
+    FILE *file;                     // Current segment file (NULL while rotated)
+    long long size;                 // Current segment size in bytes
+    long long openTime;             // Current segment opening time (seconds since epoch)
+
+    FILE *nextFile;                 // Next segment file, pre-created by background thread (NULL: not ready)
+    long long nextSize;             // Next segment size in bytes (data left by an interrupted process)
+    FILE *retiredFile;              // Previous segment file, closed and renamed by background thread
+    bool renamePending;             // Current segment written with next segment file name, renames pending
+    bool rotateRequested;           // Segment limits reached: renames and next segment creation requested
+
+    long long maxSize;              // Segment size limit in bytes (0: no limit)
+    int maxAge;                     // Segment age limit in seconds (0: no limit)
+    int maxFiles;                   // Rotated segments kept (0: no limit)
+    long long maxTotalSize;         // Rotated segments total size limit in bytes (0: no limit)
+
+    bool rotating;                  // Segment rotation in progress (no background thread), messages kept in pending buffer
+    bool compressRequested;         // Rotated segments to be compressed (retention limits applied)
+    bool compressing;               // Rotated segments compression in progress (requests made meanwhile processed too)
+    bool closing;                   // Sink closing, background thread ends
+    char *pending;                  // Messages written while rotating
+    size_t pendingSize;             // Pending messages size in bytes
+    int droppedCount;               // Messages dropped while rotating (pending buffer full)
+
+    bool threaded;                  // Background thread running (compressions done by rotating thread otherwise)
+#if defined(_WIN32)
+    void *lock;                     // Sink data access (SRWLOCK), no background thread
+#else
+    pthread_t thread;               // Background thread: segments renamed, rotated segments compressed and removed
+    pthread_mutex_t mutex;          // Sink data access
+    pthread_cond_t condition;       // Rotation or compression requested, or sink closing
+#endif
+} micLogFile;
+
+// Asynchronous operation types
+typedef enum {
+    MIC_FUTURE_COMMAND = 0,         // Child process exit
+    MIC_FUTURE_TIMER,               // Timer expiration
+    MIC_FUTURE_LOAD,                // File data loading
+    MIC_FUTURE_SAVE,                // File data saving
+} micFutureType;
+
+// Asynchronous operation, pending futures are linked in event loop list
+struct micFuture {
+    int type;                       // Operation type: enum micFutureType
+    bool ready;                     // Operation completed
+    bool detached;                  // Future unloaded while pending, freed when completed
+    int result;                     // Operation result: command exit code, 0 on success (-1 on failure)
+    int fd;                         // Event source: pidfd, timerfd or file (-1: none)
+    int pid;                        // Command process id
+    char *name;                     // Command line or file name
+    char *tempFileName;             // Temporary file written, renamed over file name (save)
+    unsigned char *data;            // File data loaded or saved
+    size_t size;                    // File data size in bytes
+    size_t done;                    // File data bytes transferred
+    bool syncing;                   // File data written, fdatasync() requested (save)
+    double startTime;               // Operation start time (milliseconds)
+    micFutureCallback callback;     // Continuation called when completed
+    void *userData;                 // Continuation user data
+    micFuture *prev;                // Previous pending future
+    micFuture *next;                // Next pending future
+};
+
+#if defined(MIC_IO_URING_AVAILABLE)
+// io_uring instance, rings shared with kernel
+typedef struct micRing {
+    int fd;                         // Ring file descriptor (-1: not available)
+    unsigned int entries;           // Submission queue entries
+    bool singleMap;                 // Submission and completion rings share one mapping
+    unsigned char *sqPtr;           // Submission ring mapping
+    unsigned char *cqPtr;           // Completion ring mapping
+    size_t sqSize;                  // Submission ring mapping size
+    size_t cqSize;                  // Completion ring mapping size
+    struct io_uring_sqe *sqes;      // Submission entries
+    size_t sqesSize;                // Submission entries mapping size
+    unsigned int *sqTail;           // Submission ring tail
+    unsigned int *sqArray;          // Submission ring entries indices
+    unsigned int sqMask;            // Submission ring index mask
+    unsigned int *cqHead;           // Completion ring head
+    unsigned int *cqTail;           // Completion ring tail
+    unsigned int cqMask;            // Completion ring index mask
+    struct io_uring_cqe *cqes;      // Completion entries
+} micRing;
+#endif
+
+// Process-wide state, shared by all contexts
 typedef struct micData {
-    int logTypeLevel;
-    TraceLogCallback traceLog;
-    
-    
+    struct {
+        unsigned int tempCounter;   // Counter for unique temporary file names (incremented atomically, saves from multiple threads)
+#if defined(__linux__)
+        int fds[MAX_SYNC_PENDING_TARGETS];          // One open file per filesystem with pending writes, for syncfs()
+        dev_t devices[MAX_SYNC_PENDING_TARGETS];    // Filesystem device ids of pending writes
+        int count;                  // Pending filesystems count
+#else
+        char **paths;               // Pending files and directories paths to be synced
+        int count;                  // Pending paths count
+        int capacity;               // Pending paths allocated capacity
+#endif
+    } Sync;
+
+    bool topologyReady;             // System topology already queried (pthread_once() on POSIX)
+    micSystemTopology topology;     // System topology (cached)
+    char memoryUsageFile[MAX_FILEPATH_LENGTH];  // cgroup memory usage file (if memory is limited)
+
+    struct {
+        int limit;                  // Maximum commands running concurrently (0: effective cores)
+        int running;                // Commands currently running
+        micRunningCommand *commands;    // Running commands slots
+        int capacity;               // Running commands slots allocated
+
+        micCommandStats *stats;     // Commands data: declared or learned peak memory
+        int statsCount;             // Commands data entries count
+        int statsCapacity;          // Commands data entries allocated
+        bool statsLoaded;           // Commands data loaded from history file
+        bool statsChanged;          // Commands data changed since last saved
+    } Jobs;
+
+
+    struct {
+        micPathEntry **pages;       // Entries pages, path id: page*PATH_ENTRIES_PAGE_SIZE + index (id 0 not used)
+        unsigned int count;         // Interned paths count (last path id)
+        unsigned int *table;        // Hash table: path ids (0: empty slot), linear probing
+        unsigned int tableSize;     // Hash table slots (power of 2)
+        char **blocks;              // Strings storage blocks
+        int blockCount;             // Storage blocks count
+        int blockCapacity;          // Storage blocks allocated
+        size_t blockUsed;           // Last block bytes used
+        size_t blockSize;           // Last block size in bytes
+    } Paths;
 } micData;
 
+// Library context: state of one pipeline
+struct micContext {
+    int logTypeLevel;               // Minimum log level emitted: enum micTraceLogLevel
+    micTraceLogCallback traceLog;   // Custom trace log callback
+    double timeBase;                // Timer base in milliseconds, set by micInitTimer()
+    int syncMode;                   // File sync mode: enum micFileSyncMode
+    unsigned int copyFlags;         // File copy flags: enum micCopyFlags
+
+    struct {
+        char description[64];       // Current step description (truncated), empty if no step running
+        double startTime;           // Current step start time (milliseconds)
+    } Step;
+
+    struct {
+        micLogFile *sink;           // Log file sink (NULL: no log file)
+        bool rotationSet;           // Rotation set with micSetTraceLogRotation() (otherwise defaults)
+        long long maxSize;          // Segment size limit in bytes (0: no limit)
+        int maxAge;                 // Segment age limit in seconds (0: no limit)
+        int maxFiles;               // Rotated segments kept (0: no limit)
+        long long maxTotalSize;     // Rotated segments total size limit in bytes (0: no limit)
+    } LogFile;
+
+    char envInfo[256];              // Environment info string, returned by micGetEnvironmentInfo()
+    char workingDir[MAX_FILEPATH_LENGTH];   // Working directory string, returned by micGetWorkingDirectory()
+    char hashString[65];            // Hash hexadecimal string, returned by micHashToString()
+
+    struct {
+        bool resume;                // Resume mode: steps completed in previous run are skipped
+        bool active;                // Process running, steps are recorded
+        bool resuming;              // All steps so far were completed in previous run
+        unsigned long long processKey;  // Process description hash
+        FILE *file;                 // Journal file, steps records appended (NULL while resuming)
+        char fileName[MAX_FILEPATH_LENGTH];     // Journal file name (process key appended in created contexts)
+
+        micJournalStep *steps;      // Previous run completed steps
+        int stepCount;              // Previous run completed steps count
+        micJournalOutput *outputs;  // Previous run steps outputs
+        int outputCount;            // Previous run steps outputs count
+        size_t headerSize;          // Previous run journal header size
+
+        int stepIndex;              // Current step index (-1: no step started)
+        unsigned long long stepKey; // Current step description hash
+        char stepDescription[64];   // Current step description (truncated)
+        bool stepCompleted;         // Current step completed in previous run (outputs unchanged)
+        char **stepOutputs;         // Current step outputs registered
+        int stepOutputCount;        // Current step outputs count
+        int stepOutputCapacity;     // Current step outputs allocated
+    } Journal;
+
+    struct {
+        bool ready;                 // Event loop initialized
+        int epollFd;                // epoll instance, events data point to futures (-1: not available)
+        micFuture *pending;         // Pending futures list
+        int pendingCount;           // Pending futures count
+        int polledCount;            // Pending commands checked with waitpid() (no pidfd)
+        int completedCount;         // Futures completed since start
+#if defined(MIC_IO_URING_AVAILABLE)
+        micRing ring;               // io_uring for file requests (fd -1: not available)
+        int ringEventFd;            // eventfd notified on ring completions, watched by epoll
+        int ringInFlight;           // Ring requests submitted not completed
+        bool ringDisabled;          // Ring submission failed, not used for new requests
+#endif
+    } Loop;
+};
+
+// File saved atomically: data written to a temporary file, renamed over target file once completed
+typedef struct micSaveTarget {
+    const char *fileName;           // Target file name
+    char tempFileName[MAX_FILEPATH_LENGTH];     // Temporary file name (empty while anonymous)
+#if defined(_WIN32)
+    FILE *file;                     // Temporary file
+#else
+    char dirPath[MAX_FILEPATH_LENGTH];          // Target file directory (synced after rename)
+    int fd;                         // Temporary file descriptor
+    bool anonymous;                 // Temporary file is anonymous (O_TMPFILE), linked to a name once completed
+#endif
+} micSaveTarget;
+
+// Parallel job function, called once for every index
+typedef void (*micJobFunc)(void *userData, int index);
+
+// Parallel jobs shared state
+typedef struct micJobs {
+    micJobFunc func;                // Function to call for every index
+    void *userData;                 // User data passed to function
+    int count;                      // Total indices to process
+    int next;                       // Next index to process (atomic)
+    micContext *context;            // Caller current context, used by worker threads (NULL: default context)
+} micJobs;
+
+// Data hashing jobs data, data split in units (BLAKE3 subtrees)
+typedef struct micHashUnits {
+    const unsigned char *data;      // Data to hash
+    size_t size;                    // Data size in bytes
+    size_t unitSize;                // Unit size in bytes (BLAKE3: power of 2 chunks)
+    int type;                       // Hash type: enum micHashType
+    uint32_t *results;              // Units results: 8 words per unit (chaining value)
+} micHashUnits;
+
+// Files hashing jobs data
+typedef struct micHashFiles {
+    const char **fileNames;         // Files to hash
+    const int *indices;             // Files indices to process (by job index)
+    int type;                       // Hash type: enum micHashType
+    int threadCount;                // Threads per file
+    micHash *hashes;                // Hashes results
+} micHashFiles;
+
+// Files metadata query jobs data
+typedef struct micFileInfoJobs {
+    const char **fileNames;         // Files to query
+    micFileInfo *infos;             // Metadata results
+} micFileInfoJobs;
+
+// DEFLATE decoder results
+typedef enum {
+    MIC_INFLATE_ERROR = -1,         // Compressed data not valid
+    MIC_INFLATE_DONE = 0,           // Stream (or block, internally) decoded
+    MIC_INFLATE_NEED_INPUT,         // More compressed data required
+    MIC_INFLATE_NEED_OUTPUT,        // Output full, must be consumed
+} micInflateResult;
+
+// DEFLATE decoder position in stream
+typedef enum {
+    MIC_INFLATE_MODE_BLOCK = 0,     // Next block header
+    MIC_INFLATE_MODE_STORED,        // Stored block data
+    MIC_INFLATE_MODE_CODES,         // Huffman compressed block data
+    MIC_INFLATE_MODE_DONE,          // Last block decoded
+} micInflateMode;
+
+// DEFLATE decoder lookup table entry kinds
+// NOTE: Entry layout: bits consumed (0-7), kind (8-11), extra bits (12-15), value (16-31)
+typedef enum {
+    MIC_INFLATE_ENTRY_INVALID = 0,  // No code (incomplete code set)
+    MIC_INFLATE_ENTRY_LITERAL,      // Literal byte (or code length symbol)
+    MIC_INFLATE_ENTRY_PAIR,         // Two literal bytes, extra bits field is first code length
+    MIC_INFLATE_ENTRY_MATCH,        // Match length or distance base, plus extra bits
+    MIC_INFLATE_ENTRY_END,          // End of block
+    MIC_INFLATE_ENTRY_SUBTABLE,     // Longer codes subtable offset, extra bits field is subtable bits
+} micInflateEntry;
+
+// DEFLATE decoder state (resumable)
+typedef struct micInflateState {
+    const unsigned char *src;       // Compressed data
+    size_t srcSize;                 // Compressed data size in bytes
+    size_t srcPosition;             // Compressed data read position
+    bool srcFinal;                  // No more compressed data after src (otherwise decoding stops to ask for more)
+    uint64_t bitBuffer;             // Bits read but not consumed
+    int bitCount;                   // Bits available in bit buffer
+    bool error;                     // Compressed data ended unexpectedly
+
+    unsigned char *dst;             // Decompressed data (previous data is the history for matches)
+    size_t dstSize;                 // Decompressed data size in bytes
+    size_t dstCapacity;             // Decompressed data buffer size in bytes
+    bool growable;                  // Decompressed data buffer can be reallocated
+
+    int mode;                       // Decoder position: enum micInflateMode
+    bool lastBlock;                 // Current block is the last one
+    size_t storedLength;            // Stored block bytes left
+    size_t matchLength;             // Match bytes left to copy
+    size_t matchDistance;           // Match distance
+    unsigned int lengthTable[INFLATE_LENGTH_TABLE_SIZE];     // Literal/length codes lookup table of current block
+    unsigned int distanceTable[INFLATE_DISTANCE_TABLE_SIZE]; // Distance codes lookup table of current block
+} micInflateState;
+
+// Line reader input modes
+typedef enum {
+    MIC_LINE_READER_BUFFERED = 0,   // File read into buffer
+    MIC_LINE_READER_MAPPED,         // File memory mapped
+    MIC_LINE_READER_GZIP,           // File decompressed into buffer
+} micLineReaderMode;
+
+// Line reader state
+struct micLineReader {
+    int mode;                       // Input mode: enum micLineReaderMode
+    char fileName[MAX_FILEPATH_LENGTH];     // File name, for logging
+    FILE *file;                     // File (buffered and gzip modes)
+
+    const unsigned char *map;       // File data (mapped mode)
+    size_t mapSize;                 // File data size in bytes (mapped mode)
+    size_t released;                // File data released (pages dropped) up to this offset (mapped mode)
+
+    unsigned char *buffer;          // Data buffer, LINE_READER_BUFFER_SIZE bytes (buffered and gzip modes)
+    size_t bufferSize;              // Data size in buffer
+    size_t position;                // Next line start, in buffer or in file data (mapped mode)
+    size_t scanned;                 // Data already searched for a line end, from next line start
+    bool splitReturn;               // Line piece returned before a '\r' (buffer full), "\r\n" line ending checked on next read
+    bool eof;                       // No more data to read into buffer
+
+    unsigned char *input;           // Compressed data buffer, LINE_READER_INPUT_SIZE bytes (gzip mode)
+    micInflateState inflate;        // DEFLATE decoder, from input to buffer (gzip mode)
+    int gzipStage;                  // Gzip member position: 0-header, 1-compressed data, 2-trailer
+    int gzipMembers;                // Gzip members decoded
+    unsigned int crc32;             // Gzip member decompressed data CRC32
+    unsigned int memberSize;        // Gzip member decompressed data size (modulo 2^32)
+};
+
+// Multi-pattern replacer: Aho-Corasick automaton as a DFA over byte classes
+struct micReplacer {
+    unsigned char classes[256];     // Byte class for every byte value (0: byte not used in keys)
+    int classCount;                 // Byte classes count (DFA table columns)
+    int stateCount;                 // DFA states count (0: root)
+    int *next;                      // DFA transitions: next[state*classCount + class]
+    int *depth;                     // State depth: size of the key prefix it represents
+    int *matchLength;               // Longest key ending at state (0: none)
+    int *matchValue;                // Value index of longest key ending at state
+    int maxKeyLength;               // Longest key size
+
+    char **values;                  // Values (copied), by key index
+    int *valueLengths;              // Values sizes
+    int valueCount;                 // Values count
+
+    char *output;                   // Output buffer (reused)
+    size_t outputSize;              // Output size in bytes
+    size_t outputCapacity;          // Output buffer size in bytes
+};
+
+// DEFLATE encoder state
+typedef struct micDeflateState {
+    const unsigned char *src;       // Data to compress
+    size_t srcSize;                 // Data size in bytes
+    size_t blockStart;              // Current block data start
+    size_t blockLength;             // Current block data length (covered by block symbols)
+
+    unsigned char *dst;             // Compressed data
+    size_t dstSize;                 // Compressed data size in bytes
+    size_t dstCapacity;             // Compressed data buffer size in bytes
+    uint64_t bitBuffer;             // Bits written but not stored
+    int bitCount;                   // Bits available in bit buffer
+    bool error;                     // Compressed data buffer could not be allocated
+
+    unsigned int *head;             // Hash chains heads: last position (+1) with a 3 bytes hash (0: none)
+    unsigned int *prev;             // Hash chains links: previous position (+1) with same hash, by position in window
+    unsigned int *symbols;          // Block symbols: literal byte, or match (distance << 16 | length)
+    int symbolCount;                // Block symbols count
+    unsigned int lengthFreqs[286];  // Block literal/length symbols frequencies
+    unsigned int distanceFreqs[30]; // Block distance symbols frequencies
+    unsigned char lengthCodes[259]; // Match length symbol by length (0-28)
+    unsigned char distanceCodes[512];   // Match distance symbol lookup (see micGetDeflateDistanceCode())
+} micDeflateState;
+
+// Zip entry extraction order
+typedef struct micZipOrder {
+    long long size;                 // Entry compressed size
+    int index;                      // Entry index
+} micZipOrder;
+
+// Zip extraction jobs data
+typedef struct micUnzipJobs {
+    const micZipArchive *zip;       // Archive to extract
+    const char *dstPath;            // Destination directory
+    const micZipOrder *order;       // Entries by job index (biggest first)
+    int *results;                   // Entries extracted (1) or failed (0)
+} micUnzipJobs;
+
+// File copy result
+typedef enum {
+    MIC_COPY_RESULT_FAILED = 0,     // File could not be copied
+    MIC_COPY_RESULT_SKIPPED,        // Destination file unchanged (sync mode)
+    MIC_COPY_RESULT_UPDATED,        // Destination file updated in place, only changed blocks written (sync mode)
+    MIC_COPY_RESULT_COPIED,         // Destination file replaced by a full copy
+} micCopyResult;
+
+// Directory copy jobs data
+typedef struct micCopyJobs {
+    char **srcFileNames;            // Source files
+    char **dstFileNames;            // Destination files
+    int count;                      // Files count
+    int capacity;                   // Files allocated
+    int *results;                   // Files results: enum micCopyResult
+    long long *written;             // Files bytes written
+} micCopyJobs;
+
 //----------------------------------------------------------------------------------
 // Global Variables Definition
 //----------------------------------------------------------------------------------
 micData MIC = { 0 };
+static micContext micDefaultContext = { 0 };                    // Context of threads without current context
+static MIC_THREAD_LOCAL micContext *micCurrentContext = NULL;   // Calling thread current context (NULL: default context)
+
+#if !defined(_WIN32)
+static pthread_mutex_t micJobsMutex = PTHREAD_MUTEX_INITIALIZER;    // Commands admission and data access
+static pthread_cond_t micJobsCondition = PTHREAD_COND_INITIALIZER;  // Signaled when a command finishes
+static pthread_mutex_t micSyncMutex = PTHREAD_MUTEX_INITIALIZER;    // Pending syncs access (files saved from multiple threads)
+static pthread_mutex_t micPathsMutex = PTHREAD_MUTEX_INITIALIZER;   // Interned paths insertion (paths interned from multiple threads)
+static pthread_once_t micTopologyOnce = PTHREAD_ONCE_INIT;          // System topology query (first caller thread, others wait)
+#endif
 
 //----------------------------------------------------------------------------------
 // Module internal Functions Declaration
 //----------------------------------------------------------------------------------
-//...
+#if !defined(_WIN32)
+static void micGetParentDirectory(const char *filePath, char *dirPath);     // Get directory part of a path into dirPath ("." if none)
+static bool micWriteFileDescriptor(int fd, const void *data, size_t size);  // Write all data to a file descriptor, retrying partial writes
+static void micSetSaveFileMode(int fd, const char *fileName, bool defaultMode);  // Set permissions of a temporary file saved over fileName (existing file permissions kept)
+static bool micSyncDirectory(const char *dirPath);                          // Sync a directory, persisting its entries (renames)
+static bool micAddPendingSync(int fd, const char *fileName, const char *dirPath);  // Register a saved file for the next sync barrier, returns true on success
+#endif
+static bool micOpenSaveTarget(micSaveTarget *target, const char *fileName);  // Open temporary file to save fileName atomically (permissions kept)
+static bool micWriteSaveTarget(micSaveTarget *target, const void *data, size_t size);  // Write data to temporary file
+static bool micCloseSaveTarget(micSaveTarget *target, bool success);        // Close temporary file, synced and renamed over target file on success (removed otherwise)
+static void micRunParallel(micJobFunc func, void *userData, int count, int threadCount);  // Run func for [0..count) indices on multiple threads (0 threads: default workers)
+static int micGetWorkerCount(void);                                         // Get default worker threads count for CPU bound jobs
+static unsigned int micGetSimdFlags(void);                                  // Get SIMD instruction sets supported by CPU and OS (CPUID)
+static void micQuerySystemTopology(void);                                   // Query system hardware topology into MIC.topology (once, see micGetSystemTopology())
+#if defined(__linux__)
+static long long micReadFileNumber(const char *fileName, long long defaultValue);  // Read a number from a small system file (sysfs, cgroup)
+static int micCountListRange(const char *list);                             // Count CPUs/nodes in a list string: "0-3,8,10-11"
+static void micGetCgroupLimits(float *cpuQuota, long long *memoryLimit, char *memoryUsageFile);  // Get cgroup (v2 or v1) CPU quota, memory limit and usage file
+#endif
+static void micFillFileInfo(micFileInfo *info, const struct stat *st);      // Fill file info from stat() data
+static unsigned long long micHashString(const char *str);                  // Compute string hash (FNV-1a), used for commands keys
+static void micGetProgramName(const char *command, char *name, int size);  // Get program name (first token, no path) from a command line
+static micCommandStats *micGetCommandStats(unsigned long long key, const char *name, bool create);  // Get command data entry (create if required)
+static long long micGetCommandMemoryEstimate(const char *command);          // Get expected peak memory for a command (0 if unknown)
+static double micGetCommandDurationEstimate(const char *command);           // Get expected duration for a command in milliseconds (0 if unknown)
+static void micUpdateCommandStats(const char *command, long long peakMemory, double duration);  // Learn command peak memory and duration from a run
+static double micUpdateStepStats(const char *description, double duration); // Learn step duration from a run, returns previous expected duration (0 if unknown)
+static void micLoadCommandStats(void);                                      // Load learned commands data from history file
+static void micSaveCommandStats(void);                                      // Save learned commands data to history file (if changed)
+static void micLoadJournal(void);                                           // Load previous run journal (if it belongs to current process)
+static void micUnloadJournal(void);                                         // Unload journal data and close journal file
+static bool micSyncJournal(bool created);                                   // Write journal data to storage, returns true on success
+static void micResetJournal(const char *description, size_t keepSize);      // Start journal: previous journal truncated to keepSize, or new journal
+static bool micIsJournalStepValid(const micJournalStep *step);              // Check journal step outputs are unchanged (metadata, hash if required)
+static void micAppendJournalStep(void);                                     // Append current step record to journal, synced to storage
+#if !defined(_WIN32)
+static int micAdmitCommand(long long estimate);                             // Wait until system state allows launching a command, returns running slot
+static void micReleaseCommand(int slot);                                    // Release running slot, wake up held back commands
+static long long micGetAvailableMemory(void);                               // Get memory available for new commands (system and cgroup)
+static float micGetPressure(const char *fileName);                          // Get pressure stall information: "some avg10" percentage
+static int micRunCommand(const char *command, int slot, long long *peakMemory);  // Spawn shell command and wait, returns exit code
+static int micRunAdmittedCommand(const char *command, int slot);            // Run an admitted command in its running slot, returns exit code
+#endif
+static void micCommandGraphJob(void *userData, int index);                  // Execute graph commands as they become ready (job for micRunParallel())
+static void micReportCriticalPath(const micCommandGraph *graph, int logLevel);  // Log predicted and actual critical path of an executed command graph
+static void micGetFileInfoJob(void *userData, int index);                   // Query one file metadata (job for micRunParallel())
+#if defined(MIC_IO_URING_AVAILABLE)
+static bool micOpenRing(micRing *ring, unsigned int entries);               // Open io_uring instance with rings mapped, returns false if not supported
+static void micCloseRing(micRing *ring);                                    // Close io_uring instance and unmap its rings
+static int micGetFileInfoBatchRing(const char **fileNames, int count, micFileInfo *infos);  // Get files metadata with io_uring STATX requests, returns -1 if not supported
+#endif
+static uint64_t micHashXxh3(const unsigned char *input, size_t length);    // Compute XXH3 64-bit hash (seed 0, default secret)
+static void micBlake3Subtree(const unsigned char *input, size_t length, uint64_t counter, bool root, uint32_t out[8]);  // BLAKE3 subtree chaining value
+static micHash micHashMemory(const unsigned char *data, size_t size, int type, int threadCount);  // Hash data in memory, big BLAKE3 inputs split in units on multiple threads
+static micHash micHashFileThreads(const char *fileName, int type, int threadCount);  // Hash file content mapped in memory
+static void micHashFileJob(void *userData, int index);                     // Hash one file (job for micRunParallel())
+static void micBuildCrc32Table(void);                                       // Build CRC32 tables (slicing-by-8)
+static void micInitCrc32Table(void);                                        // Initialize CRC32 tables, once per process (thread safe)
+static unsigned int micComputeCrc32(unsigned int crc, const unsigned char *data, size_t size);  // Compute CRC32, crc of previous data (0 to start)
+static int micInflate(micInflateState *state);                              // Inflate raw DEFLATE stream (resumable), returns enum micInflateResult
+static int micCompareZipOrder(const void *a, const void *b);                // Compare zip entries order (biggest first), qsort() callback
+static bool micParseZipDirectory(micZipArchive *zip);                       // Parse zip central directory (zip64 supported) and build names index
+static const unsigned char *micGetZipEntryCompData(const micZipArchive *zip, const micZipEntry *entry);  // Get zip entry compressed data (after local header)
+static bool micReadZipEntry(const micZipEntry *entry, const unsigned char *compData, unsigned char *dst);  // Read zip entry data into dst, CRC32 verified
+static void micMakeDirectoryTree(const char *dirPath);                      // Create a directory and all its missing parents
+static bool micIsZipPathSafe(const char *name);                             // Check zip entry name stays inside extraction directory
+static void micUnzipEntryJob(void *userData, int index);                    // Extract one zip entry (job for micRunParallel())
+static const unsigned char *micFindLineEnd(const unsigned char *data, size_t size);  // Find line end ('\n', SIMD search), returns NULL if not found
+static size_t micGetGzipHeaderSize(const unsigned char *data, size_t size); // Get gzip member header size, returns 0 if not valid or not complete
+static void micReadGzipData(micLineReader *reader);                         // Decompress gzip data into line reader buffer until full or end of file
+static size_t micFillLineReader(micLineReader *reader);                     // Refill line reader buffer, returns bytes added
+static bool micReserveReplacerOutput(micReplacer *replacer, size_t size);   // Reserve replacer output space for size more bytes
+static void micAppendReplacerOutput(micReplacer *replacer, const void *data, size_t size);   // Append data to replacer output
+static size_t micRunReplacer(micReplacer *replacer, const unsigned char *data, size_t size, bool final);  // Run replacer on data (output appended), returns bytes consumed
+static bool micInitEventLoop(void);                                         // Initialize event loop (once), returns false if not available (not Linux)
+static void micUnloadEventLoop(void);                                        // Unload event loop: epoll instance and io_uring closed
+static micFuture *micCreateFuture(int type, const char *name);              // Create pending future, added to event loop pending list
+static void micFreeFuture(micFuture *future);                               // Free future data (loaded data not taken is freed too)
+static void micCompleteFuture(micFuture *future, int result);               // Complete future: removed from pending list, continuation called, freed if unloaded
+#if defined(__linux__)
+static bool micWatchFuture(micFuture *future);                              // Watch future file descriptor (pidfd, timerfd) with event loop epoll, returns true on success
+static void micReapCommandFuture(micFuture *future);                        // Reap command future child process (if exited), completed with exit code
+#endif
+#if defined(MIC_IO_URING_AVAILABLE)
+static bool micTransferFileFuture(micFuture *future);                       // Transfer file future remaining data synchronously, returns true on success
+static void micFinishFileFuture(micFuture *future, bool success);           // Finish file future: file closed (saved file renamed over target and synced), completed
+static bool micSubmitFileFuture(micFuture *future);                         // Submit next ring request of a file future, returns false if not submitted
+static void micProcessRingEvents(void);                                     // Process ring completions: file futures advanced to next request or finished
+#endif
+static size_t micNormalizePath(char *path, size_t length);                  // Normalize path in place (lexically), returns normalized length
+static micPathEntry *micGetPathEntry(unsigned int pathId);                  // Get interned path entry (NULL if id not valid)
+static unsigned int micInternPathData(const char *path, size_t length, bool insert);  // Get path id of path data, inserted if not found and insert requested
+static unsigned int micInternPathJoin(const char *dirPath, const char *path, bool insert);  // Normalize and intern path joined to a directory path, returns path id
+static unsigned int micInternFullPath(const char *path);                    // Normalize and intern full path (relative paths resolved against working directory)
+static char **micLoadDirectoryEntries(const char *dirPath, int *count);     // Load directory entries names (no "." or ".."), returns NULL if directory can not be read
+static void micUnloadDirectoryEntries(char **entries, int count);           // Unload directory entries names
+#if !defined(_WIN32)
+static size_t micReadFileAt(int fd, void *data, size_t size, long long offset);   // Read data at file offset, retrying partial reads, returns bytes read
+static bool micWriteFileAt(int fd, const void *data, size_t size, long long offset);  // Write all data at file offset, retrying partial writes
+static void micSetFileAttributes(int fd, const struct stat *srcInfo);      // Set file permissions and access/modification times from source file info
+#endif
+static long long micCopyFileData(const char *srcFileName, const char *dstFileName, const struct stat *srcInfo);  // Copy file whole (replaced atomically), returns bytes written (-1 on failure)
+#if !defined(_WIN32)
+static long long micUpdateFileData(const char *srcFileName, const char *dstFileName, const struct stat *srcInfo);  // Update file in place, only changed blocks written, returns bytes written (-1 on failure)
+#endif
+static int micCopyFileEntry(const char *srcFileName, const char *dstFileName, const struct stat *srcInfo, long long *written);  // Copy one file (copy flags applied), returns enum micCopyResult
+static int micCollectCopyJobs(micCopyJobs *jobs, const char *srcDirPath, const char *dstDirPath);    // Create destination directories (links copied), collect files to copy, returns entries failed
+static void micCopyFileJob(void *userData, int index);                      // Copy one file (job for micRunParallel())
+static bool micRemovePathTree(const char *path);                            // Remove file, link or directory with all its content
+static int micDeleteExtraneousEntries(const char *srcDirPath, const char *dstDirPath, int *failed);   // Delete destination entries not available in source, returns entries deleted
+static inline int micGetDeflateDistanceCode(const micDeflateState *state, unsigned int distance);  // Get match distance symbol (distance lookup table)
+static bool micReserveDeflateOutput(micDeflateState *state, size_t size);   // Reserve compressed data space for size more bytes
+static inline void micWriteDeflateBits(micDeflateState *state, unsigned int value, int count);  // Write bits to compressed data (LSB first), space must be reserved
+static void micFlushDeflateBits(micDeflateState *state);                   // Write remaining bits to compressed data, padded to a byte boundary
+static int micFindDeflateMatch(micDeflateState *state, size_t position, int minLength, unsigned int *distance);  // Find longest match (hash chains), returns 0 if none longer than minLength
+static void micBuildDeflateLengths(const unsigned int *freqs, int count, int maxBits, unsigned char *lengths);  // Build length limited Huffman code lengths from symbols frequencies
+static void micBuildDeflateCodes(const unsigned char *lengths, int count, unsigned short *codes);   // Build canonical Huffman codes from code lengths (bit reversed, LSB first)
+static void micWriteDeflateBlock(micDeflateState *state, bool last);        // Write block with collected symbols (dynamic, fixed or stored, smallest)
+static unsigned char *micDeflate(const unsigned char *data, size_t size, size_t *compSize);    // Compress data into raw DEFLATE stream (lazy matching), returns NULL on failure
+static void micWriteLogMessage(micLogFile *sink, int logLevel, const char *text, va_list args);  // Write message to log file (time stamp, level), rotation requested if required
+static inline void micLockLogFile(micLogFile *sink);                        // Lock log file sink data
+static inline void micUnlockLogFile(micLogFile *sink);                      // Unlock log file sink data
+static void micRotateLogFile(micLogFile *sink);                             // Rotate log file: current segment renamed, new segment opened, compression requested
+static bool micRenameLogSegment(const char *fileName);                      // Rename log file segment with a time stamp suffix, returns true on success
+static void micPrepareLogSegments(micLogFile *sink);                        // Complete segment switch (previous segment renamed), pre-create next segment
+static bool micIsLogSegment(const char *name, const char *baseName, bool *compressed);  // Check file name is a rotated segment of a log file
+static int micCompareLogSegments(const void *a, const void *b);            // Compare segments names (oldest first), qsort() callback
+static bool micCompressLogSegment(const char *fileName);                    // Compress rotated segment into gzip file (segment removed), returns true on success
+static void micProcessLogSegments(const char *fileName, int maxFiles, long long maxTotalSize);  // Compress rotated segments not compressed yet, delete segments over retention limits
+static void micCompressLogFile(micLogFile *sink);                           // Process rotated segments while compression is requested, one thread at a time
+static void micCloseLogFile(micLogFile *sink);                              // Close log file sink, requested renames and compression completed first
+#if !defined(_WIN32)
+static void *micLogFileWorker(void *data);                                  // Log file background thread: segments renames, rotated segments compressions
+#endif
 
 //----------------------------------------------------------------------------------
 // Module Functions Definition
 //----------------------------------------------------------------------------------
 
+// Context management
+//----------------------------------------------------------------------------------
+
+// Create library context: log settings, timer, file sync mode, steps journal, event loop
+// NOTE: Context starts with current context log settings (log file not shared) and file sync mode, its timer starts now;
+// it is used by a thread once set with micSetCurrentContext() (worker threads inherit it)
+micContext *micCreateContext(void)
+{
+    micContext *context = (micContext *)MIC_CALLOC(1, sizeof(micContext));
+    if (context == NULL) return NULL;
+
+    context->logTypeLevel = CTX.logTypeLevel;
+    context->traceLog = CTX.traceLog;
+    context->syncMode = CTX.syncMode;
+    context->copyFlags = CTX.copyFlags;
+    context->LogFile = CTX.LogFile;
+    context->LogFile.sink = NULL;
+    context->timeBase = CTX.timeBase + micGetTime();
+
+    return context;
+}
+
+// Destroy library context (pending asynchronous operations completed first)
+// NOTE: Context must not be current in other threads, default context can not be destroyed
+void micDestroyContext(micContext *context)
+{
+    if ((context == NULL) || (context == &micDefaultContext)) return;
+
+    micContext *previous = micCurrentContext;
+    micCurrentContext = context;
+
+    while (CTX.Loop.pendingCount > 0) micPollEvents(-1);
+
+    if (CTX.syncMode == MIC_FILE_SYNC_BATCHED) micSyncFiles();
+    if (CTX.Journal.active) micUnloadJournal();
+    if (CTX.LogFile.sink != NULL) micCloseLogFile(CTX.LogFile.sink);
+    micUnloadEventLoop();
+
+    micCurrentContext = (previous != context)? previous : NULL;
+
+    MIC_FREE(context);
+}
+
+// Set context used by calling thread (NULL: default context)
+void micSetCurrentContext(micContext *context)
+{
+    micCurrentContext = (context != &micDefaultContext)? context : NULL;
+}
+
+// Get context used by calling thread
+micContext *micGetCurrentContext(void)
+{
+    return &CTX;
+}
+
 // Log System
 //----------------------------------------------------------------------------------
 
@@ -324,14 +1384,22 @@ micData MIC = { 0 };
 void micTraceLog(int logLevel, const char *text, ...)
 {
     // Message has level below current threshold, don't emit
-    if (logLevel < MIC.logTypeLevel) return;
+    if (logLevel < CTX.logTypeLevel) return;
 
     va_list args;
     va_start(args, text);
 
-    if (MIC.traceLog)
+    if (CTX.LogFile.sink != NULL)
     {
-        Mic.traceLog(logLevel, text, args);
+        va_list fileArgs;
+        va_copy(fileArgs, args);
+        micWriteLogMessage(CTX.LogFile.sink, logLevel, text, fileArgs);
+        va_end(fileArgs);
+    }
+
+    if (CTX.traceLog)
+    {
+        CTX.traceLog(logLevel, text, args);
         va_end(args);
         return;
     }
@@ -355,19 +1423,99 @@ void micTraceLog(int logLevel, const char *text, ...)
 
     va_end(args);
 
-    if (logLevel == LOG_FATAL) exit(EXIT_FAILURE);  // If fatal logging, exit program
+    if (logLevel == MIC_LOG_FATAL) exit(EXIT_FAILURE);  // If fatal logging, exit program
 }
 
 // Set the current threshold (minimum) log level
 void micSetTraceLogLevel(int logLevel)
 {
-    MIC.logTypeLevel = logLevel;
+    CTX.logTypeLevel = logLevel;
 }
 
 // Set custom trace log
 void micSetTraceLogCallback(micTraceLogCallback callback)
 {
-    MIC.traceLog = callback;
+    CTX.traceLog = callback;
+}
+
+// Set trace log file: messages also appended to file (time stamped), rotated segments compressed (NULL: close)
+// NOTE: Segments reaching rotation limits (micSetTraceLogRotation()) are renamed with a time stamp suffix and
+// compressed (.gz) by a background thread, logging thread reaching them only switches to a next segment file
+// pre-created by background thread (<fileName>.next, renamed to fileName once previous segment is renamed).
+// On Windows there is no background thread, segments are rotated and compressed by the logging thread
+// reaching the limits (other threads never wait)
+bool micSetTraceLogFile(const char *fileName)
+{
+    if (CTX.LogFile.sink != NULL)
+    {
+        micCloseLogFile(CTX.LogFile.sink);
+        CTX.LogFile.sink = NULL;
+    }
+
+    if (fileName == NULL) return true;
+
+    micLogFile *sink = (micLogFile *)MIC_CALLOC(1, sizeof(micLogFile));
+    if (sink == NULL) return false;
+
+    if ((snprintf(sink->fileName, MAX_FILEPATH_LENGTH, "%s", fileName) >= MAX_FILEPATH_LENGTH) ||
+        (snprintf(sink->nextFileName, MAX_FILEPATH_LENGTH, "%s.next", fileName) >= MAX_FILEPATH_LENGTH)) sink->file = NULL;
+    else sink->file = fopen(fileName, "ab");
+
+    if (sink->file == NULL)
+    {
+        MIC_FREE(sink);
+        micTraceLog(MIC_LOG_WARNING, "[%s] Log file could not be opened", fileName);
+        return false;
+    }
+
+    if (fseek(sink->file, 0, SEEK_END) == 0) sink->size = (long long)ftell(sink->file);
+    sink->openTime = (long long)time(NULL);
+
+    sink->maxSize = CTX.LogFile.rotationSet? CTX.LogFile.maxSize : LOG_FILE_MAX_SIZE;
+    sink->maxAge = CTX.LogFile.rotationSet? CTX.LogFile.maxAge : 0;
+    sink->maxFiles = CTX.LogFile.rotationSet? CTX.LogFile.maxFiles : LOG_FILE_MAX_FILES;
+    sink->maxTotalSize = CTX.LogFile.rotationSet? CTX.LogFile.maxTotalSize : 0;
+
+    micInitCrc32Table();
+
+    // Next segment pre-created, segments left by previous runs compressed
+    sink->rotateRequested = true;
+    sink->compressRequested = true;
+
+#if !defined(_WIN32)
+    pthread_mutex_init(&sink->mutex, NULL);
+    pthread_cond_init(&sink->condition, NULL);
+    sink->threaded = (pthread_create(&sink->thread, NULL, micLogFileWorker, sink) == 0);
+#endif
+    if (!sink->threaded) micCompressLogFile(sink);
+
+    CTX.LogFile.sink = sink;
+    micTraceLog(MIC_LOG_INFO, "[%s] Log file opened successfully", fileName);
+
+    return true;
+}
+
+// Set log file rotation: segment size (bytes) and age (seconds) limits, rotated segments kept (count, total bytes), 0: no limit
+// NOTE: Defaults: LOG_FILE_MAX_SIZE segments, LOG_FILE_MAX_FILES rotated segments kept
+void micSetTraceLogRotation(long long maxSize, int maxAge, int maxFiles, long long maxTotalSize)
+{
+    CTX.LogFile.rotationSet = true;
+    CTX.LogFile.maxSize = maxSize;
+    CTX.LogFile.maxAge = maxAge;
+    CTX.LogFile.maxFiles = maxFiles;
+    CTX.LogFile.maxTotalSize = maxTotalSize;
+
+    micLogFile *sink = CTX.LogFile.sink;
+
+    if (sink != NULL)
+    {
+        micLockLogFile(sink);
+        sink->maxSize = maxSize;
+        sink->maxAge = maxAge;
+        sink->maxFiles = maxFiles;
+        sink->maxTotalSize = maxTotalSize;
+        micUnlockLogFile(sink);
+    }
 }
 
 // Environment
@@ -394,106 +1542,582 @@ void micSetEnvironmentPath(const char *path)
 // Get environment info: enum micEnvInfo
 const char *micGetEnvironmentInfo(int info)
 {
-    static char buffer[256] = { 0 };
-    
+    char *buffer = CTX.envInfo;
+    memset(buffer, 0, 256);
+
+    const micSystemTopology *topology = micGetSystemTopology();
+
+#if !defined(_WIN32)
+    struct utsname system = { 0 };
+    uname(&system);
+#endif
+
     switch (info)
     {
-        case MIC_ENV_INFO_OS: break;
-        case MIC_ENV_INFO_OS_VERSION: break;
-        case MIC_ENV_INFO_PLATFORM: break;
-        case MIC_ENV_INFO_MACHINE_NAME: break;
+#if defined(_WIN32)
+        case MIC_ENV_INFO_OS: strcpy(buffer, "Windows"); break;
+        case MIC_ENV_INFO_OS_VERSION: if (getenv("OS") != NULL) snprintf(buffer, 256, "%s", getenv("OS")); break;
+        case MIC_ENV_INFO_PLATFORM: if (getenv("PROCESSOR_ARCHITECTURE") != NULL) snprintf(buffer, 256, "%s", getenv("PROCESSOR_ARCHITECTURE")); break;
+        case MIC_ENV_INFO_MACHINE_NAME: if (getenv("COMPUTERNAME") != NULL) snprintf(buffer, 256, "%s", getenv("COMPUTERNAME")); break;
+#else
+        case MIC_ENV_INFO_OS: snprintf(buffer, 256, "%s", system.sysname); break;
+        case MIC_ENV_INFO_OS_VERSION: snprintf(buffer, 256, "%s", system.release); break;
+        case MIC_ENV_INFO_PLATFORM: snprintf(buffer, 256, "%s", system.machine); break;
+        case MIC_ENV_INFO_MACHINE_NAME: snprintf(buffer, 256, "%s", system.nodename); break;
+#endif
+        case MIC_ENV_INFO_CPU_LOGICAL_CORES: snprintf(buffer, 256, "%i", topology->logicalCores); break;
+        case MIC_ENV_INFO_CPU_PHYSICAL_CORES: snprintf(buffer, 256, "%i", topology->physicalCores); break;
+        case MIC_ENV_INFO_CPU_QUOTA: snprintf(buffer, 256, "%.2f", topology->cpuQuota); break;
+        case MIC_ENV_INFO_CPU_CORES_EFFECTIVE: snprintf(buffer, 256, "%i", topology->effectiveCores); break;
+        case MIC_ENV_INFO_MEMORY_TOTAL: snprintf(buffer, 256, "%lli", topology->memoryTotal); break;
+        case MIC_ENV_INFO_MEMORY_LIMIT: snprintf(buffer, 256, "%lli", topology->memoryLimit); break;
+        case MIC_ENV_INFO_NUMA_NODES: snprintf(buffer, 256, "%i", topology->numaNodes); break;
+        case MIC_ENV_INFO_CACHE_L1: snprintf(buffer, 256, "%i", topology->cacheL1); break;
+        case MIC_ENV_INFO_CACHE_L2: snprintf(buffer, 256, "%i", topology->cacheL2); break;
+        case MIC_ENV_INFO_CACHE_L3: snprintf(buffer, 256, "%i", topology->cacheL3); break;
+        case MIC_ENV_INFO_SIMD:
+        {
+            static const char *simdNames[] = { "SSE2", "SSSE3", "SSE4.1", "SSE4.2", "AVX", "AVX2", "AVX512F", "", "NEON" };
+
+            for (int i = 0; i < 9; i++)
+            {
+                if (topology->simd & (1u << i)) { strcat(buffer, simdNames[i]); strcat(buffer, " "); }
+            }
+
+            if (buffer[0] != '\0') buffer[strlen(buffer) - 1] = '\0';
+        } break;
         default: break;
     }
-    
+
     return buffer;
 }
 
+// Get system hardware topology (queried once, cached)
+// NOTE: Data comes from sysfs, cgroup (v2 or v1) files and CPUID on Linux, sysctl on macOS,
+// it is used to default worker threads, jobs limits and blocks sizes inside containers,
+// where the number of online CPUs does not reflect the CPU quota assigned
+const micSystemTopology *micGetSystemTopology(void)
+{
+    // NOTE: Jobs threads can query topology concurrently, only first call fills it (others wait)
+#if !defined(_WIN32)
+    pthread_once(&micTopologyOnce, micQuerySystemTopology);
+#else
+    if (!MIC.topologyReady) micQuerySystemTopology();
+#endif
+
+    return &MIC.topology;
+}
+
+// Query system hardware topology into MIC.topology
+static void micQuerySystemTopology(void)
+{
+    micSystemTopology topology = { 0 };
+
+#if defined(__linux__)
+    topology.logicalCores = (int)sysconf(_SC_NPROCESSORS_ONLN);
+
+    // NOTE: Raw syscall instead of sched_getaffinity()/CPU_COUNT(), only declared with _GNU_SOURCE,
+    // kernel returns the number of mask bytes written (1024 CPUs covered, same as cpu_set_t)
+    unsigned long affinity[1024/(8*sizeof(unsigned long))] = { 0 };
+    long maskSize = syscall(SYS_sched_getaffinity, 0, sizeof(affinity), affinity);
+
+    if (maskSize > 0)
+    {
+        int affinityCount = 0;
+        for (int i = 0; i < (int)(maskSize/sizeof(unsigned long)); i++) affinityCount += __builtin_popcountl(affinity[i]);
+        if (affinityCount > 0) topology.logicalCores = affinityCount;
+    }
+
+    // Physical cores: count CPUs that are the first of their SMT siblings list
+    int cpuCount = (int)sysconf(_SC_NPROCESSORS_CONF);
+    char path[128] = { 0 };
+
+    for (int i = 0; i < cpuCount; i++)
+    {
+        snprintf(path, 128, "/sys/devices/system/cpu/cpu%i/topology/thread_siblings_list", i);
+        long long firstSibling = micReadFileNumber(path, -1);
+        if (firstSibling == i) topology.physicalCores++;
+    }
+
+    topology.memoryTotal = (long long)sysconf(_SC_PHYS_PAGES)*(long long)sysconf(_SC_PAGESIZE);
+
+    FILE *nodes = fopen("/sys/devices/system/node/online", "rt");
+    if (nodes != NULL)
+    {
+        char list[256] = { 0 };
+        if (fgets(list, 256, nodes) != NULL) topology.numaNodes = micCountListRange(list);
+        fclose(nodes);
+    }
+
+    // Caches sizes, as reported for first CPU: size format is "48K" or "32M"
+    for (int i = 0; i < 8; i++)
+    {
+        char value[32] = { 0 };
+
+        snprintf(path, 128, "/sys/devices/system/cpu/cpu0/cache/index%i/level", i);
+        int level = (int)micReadFileNumber(path, 0);
+        if (level == 0) break;
+
+        snprintf(path, 128, "/sys/devices/system/cpu/cpu0/cache/index%i/type", i);
+        FILE *file = fopen(path, "rt");
+        if (file == NULL) continue;
+        bool instruction = ((fgets(value, 32, file) != NULL) && (strncmp(value, "Instruction", 11) == 0));
+        fclose(file);
+        if (instruction) continue;
+
+        snprintf(path, 128, "/sys/devices/system/cpu/cpu0/cache/index%i/size", i);
+        file = fopen(path, "rt");
+        if (file == NULL) continue;
+        long long size = 0;
+        if (fgets(value, 32, file) != NULL)
+        {
+            char *unit = NULL;
+            size = strtoll(value, &unit, 10);
+            if (*unit == 'K') size *= 1024;
+            else if (*unit == 'M') size *= 1024*1024;
+        }
+        fclose(file);
+
+        if (level == 1) topology.cacheL1 = (int)size;
+        else if (level == 2) topology.cacheL2 = (int)size;
+        else if (level == 3) topology.cacheL3 = (int)size;
+    }
+
+    micGetCgroupLimits(&topology.cpuQuota, &topology.memoryLimit, MIC.memoryUsageFile);
+#elif defined(__APPLE__)
+    long long value = 0;
+    size_t size = sizeof(long long);
+
+    if (sysctlbyname("hw.logicalcpu", &value, &size, NULL, 0) == 0) topology.logicalCores = (int)value;
+    size = sizeof(long long); value = 0;
+    if (sysctlbyname("hw.physicalcpu", &value, &size, NULL, 0) == 0) topology.physicalCores = (int)value;
+    size = sizeof(long long); value = 0;
+    if (sysctlbyname("hw.memsize", &value, &size, NULL, 0) == 0) topology.memoryTotal = value;
+    size = sizeof(long long); value = 0;
+    if (sysctlbyname("hw.l1dcachesize", &value, &size, NULL, 0) == 0) topology.cacheL1 = (int)value;
+    size = sizeof(long long); value = 0;
+    if (sysctlbyname("hw.l2cachesize", &value, &size, NULL, 0) == 0) topology.cacheL2 = (int)value;
+    size = sizeof(long long); value = 0;
+    if (sysctlbyname("hw.l3cachesize", &value, &size, NULL, 0) == 0) topology.cacheL3 = (int)value;
+#elif defined(_WIN32)
+    if (getenv("NUMBER_OF_PROCESSORS") != NULL) topology.logicalCores = atoi(getenv("NUMBER_OF_PROCESSORS"));
+#endif
+
+    // Defaults for values not available
+    if (topology.logicalCores <= 0) topology.logicalCores = 1;
+    if ((topology.physicalCores <= 0) || (topology.physicalCores > topology.logicalCores)) topology.physicalCores = topology.logicalCores;
+    if (topology.numaNodes <= 0) topology.numaNodes = 1;
+
+    topology.effectiveCores = topology.logicalCores;
+    if ((topology.cpuQuota > 0.0f) && ((int)(topology.cpuQuota + 0.999f) < topology.effectiveCores)) topology.effectiveCores = (int)(topology.cpuQuota + 0.999f);
+    if (topology.effectiveCores < 1) topology.effectiveCores = 1;
+
+    topology.simd = micGetSimdFlags();
+
+    MIC.topology = topology;
+    MIC.topologyReady = true;
+
+    micTraceLog(MIC_LOG_DEBUG, "System topology: %i logical cores, %i physical, quota %.2f, %i effective, %i NUMA nodes",
+        topology.logicalCores, topology.physicalCores, topology.cpuQuota, topology.effectiveCores, topology.numaNodes);
+}
+
 // Processes execution
 //----------------------------------------------------------------------------------
 
 // [!] Begin a new process -> Not sure yet how use this, maybe just for logging...
+// NOTE: A journal of completed steps is started (MIC_JOURNAL_FILE), in resume mode the journal
+// of previous run of the same process is loaded and its completed steps can be skipped
 void micBeginProcess(const char *description, int level)
 {
+    if (CTX.Journal.active) micUnloadJournal();
+    if (description == NULL) description = "";
 
+    CTX.Journal.active = true;
+    CTX.Journal.processKey = micHashString(description);
+    CTX.Journal.stepIndex = -1;
+
+    // NOTE: Created contexts get their own journal file, pipelines running side by side do not share it
+    if (micCurrentContext == NULL) strcpy(CTX.Journal.fileName, MIC_JOURNAL_FILE);
+    else snprintf(CTX.Journal.fileName, MAX_FILEPATH_LENGTH, "%s.%016llx", MIC_JOURNAL_FILE, CTX.Journal.processKey);
+
+    if (CTX.Journal.resume) micLoadJournal();
+
+    if (CTX.Journal.stepCount > 0)
+    {
+        // Journal is kept as it is while steps are found completed
+        CTX.Journal.resuming = true;
+        micTraceLog(MIC_LOG_INFO, "[%s] Process resumed, %i steps completed in previous run", description, CTX.Journal.stepCount);
+    }
+    else micResetJournal(description, 0);
 }
 
 // End current process
 void micEndProcess(void)
 {
+    // Pending asynchronous operations are completed before ending
+    while (CTX.Loop.pendingCount > 0) micPollEvents(-1);
+
+    if (CTX.syncMode == MIC_FILE_SYNC_BATCHED) micSyncFiles();
 
+    micSaveCommandStats();
+
+    if (CTX.Journal.active) micUnloadJournal();
 }
 
 // [!] Begin a new process step -> Not sure yet how use it
+// NOTE: In resume mode, step is completed if previous run completed it (same description and position)
+// with its outputs unchanged, and all previous steps are completed too; check it with micIsStepCompleted()
 void micBeginStep(const char *description, int level)
 {
+    if (description == NULL) description = "";
+
+    // Step duration measured until micEndStep(), learned between runs
+    snprintf(CTX.Step.description, 64, "%.*s", (int)strcspn(description, "\r\n"), description);
+    CTX.Step.startTime = micGetTime();
 
+    if (!CTX.Journal.active) return;
+
+    CTX.Journal.stepIndex++;
+    CTX.Journal.stepKey = micHashString(description);
+    CTX.Journal.stepCompleted = false;
+    snprintf(CTX.Journal.stepDescription, 64, "%.*s", (int)strcspn(description, "\r\n"), description);
+
+    for (int i = 0; i < CTX.Journal.stepOutputCount; i++) MIC_FREE(CTX.Journal.stepOutputs[i]);
+    CTX.Journal.stepOutputCount = 0;
+
+    if (CTX.Journal.resuming)
+    {
+        int index = CTX.Journal.stepIndex;
+
+        if ((index < CTX.Journal.stepCount) && (CTX.Journal.steps[index].key == CTX.Journal.stepKey) && micIsJournalStepValid(&CTX.Journal.steps[index]))
+        {
+            CTX.Journal.stepCompleted = true;
+            micTraceLog(MIC_LOG_INFO, "[%s] Step completed in previous run, outputs unchanged", description);
+        }
+        else
+        {
+            // First step not completed: journal keeps previous steps, next ones are appended
+            CTX.Journal.resuming = false;
+            micResetJournal(NULL, (index > 0)? CTX.Journal.steps[index - 1].end : CTX.Journal.headerSize);
+            micTraceLog(MIC_LOG_INFO, "[%s] Step not completed in previous run (or outputs changed), process continues from here", description);
+        }
+    }
 }
 
 // End current step
+// NOTE: In MIC_FILE_SYNC_BATCHED mode all files saved during the step share one sync barrier here,
+// then step is appended to journal (with outputs fingerprints) and journal is synced;
+// step duration is compared with previous runs and learned (unless skipped in resume mode)
 void micEndStep(void)
 {
+    if (CTX.syncMode == MIC_FILE_SYNC_BATCHED) micSyncFiles();
 
-}
+    if ((CTX.Step.description[0] != '\0') && !micIsStepCompleted())
+    {
+        double elapsedTime = micGetTime() - CTX.Step.startTime;
+        double expectedTime = micUpdateStepStats(CTX.Step.description, elapsedTime);
 
-// Execute command line command, parameters passed as additional arguments
-int micExecuteCommand(const char *command, ...)
-{
-    static char fullCmd[256] = { 0 }; //(char *)MIC_CALLOC(256, sizeof(char));
-    
-    va_list args;
-    va_start(args, text);
+        if (expectedTime > 0) micTraceLog(MIC_LOG_INFO, "[%s] Step finished in %.2f ms (expected %.2f ms)", CTX.Step.description, elapsedTime, expectedTime);
+        else micTraceLog(MIC_LOG_INFO, "[%s] Step finished in %.2f ms", CTX.Step.description, elapsedTime);
+    }
 
-    strcpy(fullCmd, "%s ", command);
-    vprintf(buffer, args);
+    CTX.Step.description[0] = '\0';
 
-    va_end(args);
+    micSaveCommandStats();
 
-    system(cmd);
-    //MIC_FREE(cmd);
-    
-    //execv(args[0], args);
+    if (CTX.Journal.active && (CTX.Journal.stepIndex >= 0) && !CTX.Journal.stepCompleted) micAppendJournalStep();
 }
 
-// Compile and execute another mic file
-int micExecuteMIC(const char *micFile)
+// Set resume mode: steps completed in previous run (journal) are skipped, if their outputs are unchanged
+// NOTE: Must be set before micBeginProcess()
+void micSetResumeMode(bool resume)
 {
-
+    CTX.Journal.resume = resume;
 }
 
-// Timming
-//----------------------------------------------------------------------------------
-// [!] Initialize internal timer -> Support multiple timers?
-void micInitTimer(void)
+// Check if current step was completed in previous run (resume mode), step work can be skipped
+bool micIsStepCompleted(void)
 {
-// Setting a higher resolution can improve the accuracy of time-out intervals in wait functions.
-// However, it can also reduce overall system performance, because the thread scheduler switches tasks more often.
-// High resolutions can also prevent the CPU power management system from entering power-saving modes.
-// Setting a higher resolution does not improve the accuracy of the high-resolution performance counter.
-#if defined(_WIN32) && defined(SUPPORT_WINMM_HIGHRES_TIMER) && !defined(SUPPORT_BUSY_WAIT_LOOP)
-    timeBeginPeriod(1);                 // Setup high-resolution timer to 1ms (granularity of 1-2 ms)
-#endif
+    return CTX.Journal.active && CTX.Journal.stepCompleted;
+}
 
-#if defined(PLATFORM_ANDROID) || defined(PLATFORM_RPI) || defined(PLATFORM_DRM)
-    struct timespec now = { 0 };
+// Register current step output file, its fingerprint is saved to journal at micEndStep()
+void micAddStepOutput(const char *fileName)
+{
+    if (!CTX.Journal.active || (CTX.Journal.stepIndex < 0) || CTX.Journal.stepCompleted || (fileName == NULL)) return;
 
-    if (clock_gettime(CLOCK_MONOTONIC, &now) == 0)  // Success
+    if (CTX.Journal.stepOutputCount >= CTX.Journal.stepOutputCapacity)
     {
-        MIC.Time.base = (unsigned long long int)now.tv_sec*1000000000LLU + (unsigned long long int)now.tv_nsec;
+        int capacity = (CTX.Journal.stepOutputCapacity == 0)? 16 : CTX.Journal.stepOutputCapacity*2;
+        char **outputs = (char **)MIC_REALLOC(CTX.Journal.stepOutputs, capacity*sizeof(char *));
+        if (outputs == NULL) return;
+
+        CTX.Journal.stepOutputs = outputs;
+        CTX.Journal.stepOutputCapacity = capacity;
     }
-    else TRACELOG(LOG_WARNING, "TIMER: Hi-resolution timer not available");
-#endif
 
-    MIC.Time.previous = micGetTime();     // Get time as double
+    char *path = (char *)MIC_MALLOC(strlen(fileName) + 1);
+    if (path == NULL) return;
+    strcpy(path, fileName);
+
+    CTX.Journal.stepOutputs[CTX.Journal.stepOutputCount++] = path;
 }
 
-// Get elapsed time in seconds since micInitTimer()
-// Time measure returned are milliseconds
-double micGetTime(void)
+// Execute command line command, parameters passed as additional arguments
+// NOTE: Command is launched when system state allows it: running commands under jobs limit,
+// memory available for the command expected peak memory (declared or learned from previous runs)
+// and no memory/CPU pressure stall, returns command exit code (-1 if it could not be launched)
+int micExecuteCommand(const char *command, ...)
 {
-    double time = 0;
-
-#if defined(_WIN32)
-    unsigned long long int clockFrequency, currentTime;
+    if (command == NULL) return -1;
+
+    va_list args;
+    va_start(args, command);
+    int length = vsnprintf(NULL, 0, command, args);
+    va_end(args);
+
+    if (length < 0) return -1;
+
+    char *fullCommand = (char *)MIC_MALLOC(length + 1);
+    if (fullCommand == NULL) return -1;
+
+    va_start(args, command);
+    vsnprintf(fullCommand, length + 1, command, args);
+    va_end(args);
+
+    int result = -1;
+
+#if defined(_WIN32)
+    double startTime = micGetTime();
+    result = system(fullCommand);
+
+    if (result == 0) micUpdateCommandStats(fullCommand, 0, micGetTime() - startTime);
+#else
+    int slot = micAdmitCommand(micGetCommandMemoryEstimate(fullCommand));
+    result = micRunAdmittedCommand(fullCommand, slot);
+    micReleaseCommand(slot);
+#endif
+
+    if (result != 0) micTraceLog(MIC_LOG_WARNING, "[%s] Command failed with exit code %i", fullCommand, result);
+
+    MIC_FREE(fullCommand);
+
+    return result;
+}
+
+// Execute multiple commands concurrently (admission controlled), returns failed commands count
+// NOTE: Commands without dependencies, longest expected commands (previous runs) are launched first
+int micExecuteCommandList(const char **commands, int count)
+{
+    return micExecuteCommandGraph(commands, count, NULL, 0);
+}
+
+// Execute commands with dependencies concurrently (admission controlled), returns failed commands count
+// NOTE: Dependencies are index pairs: dependencies[2*i] must finish before dependencies[2*i + 1] starts,
+// commands depending on a failed command are not executed (counted as failed). Ready commands are launched
+// by longest remaining path to graph end first (critical path), from durations learned in previous runs
+int micExecuteCommandGraph(const char **commands, int count, const int *dependencies, int dependencyCount)
+{
+    if ((commands == NULL) || (count <= 0)) return 0;
+    if (dependencies == NULL) dependencyCount = 0;
+
+    micCommandGraph graph = { 0 };
+    graph.nodes = (micGraphNode *)MIC_CALLOC(count, sizeof(micGraphNode));
+    graph.successors = (int *)MIC_CALLOC((dependencyCount > 0)? dependencyCount : 1, sizeof(int));
+    graph.ready = (int *)MIC_CALLOC(count, sizeof(int));
+    graph.count = count;
+    int *order = (int *)MIC_CALLOC(count, sizeof(int));
+
+    if ((graph.nodes == NULL) || (graph.successors == NULL) || (graph.ready == NULL) || (order == NULL))
+    {
+        MIC_FREE(graph.nodes);
+        MIC_FREE(graph.successors);
+        MIC_FREE(graph.ready);
+        MIC_FREE(order);
+        return count;
+    }
+
+    for (int i = 0; i < count; i++)
+    {
+        graph.nodes[i].command = commands[i];
+        graph.nodes[i].estimate = micGetCommandDurationEstimate(commands[i]);
+        graph.nodes[i].gate = -1;
+        graph.nodes[i].result = -1;
+    }
+
+    // Successors lists, grouped by predecessor
+    for (int i = 0; i < dependencyCount; i++)
+    {
+        int before = dependencies[2*i];
+        int after = dependencies[2*i + 1];
+
+        if ((before < 0) || (before >= count) || (after < 0) || (after >= count) || (before == after))
+        {
+            micTraceLog(MIC_LOG_WARNING, "Command graph dependency not valid (%i -> %i), ignored", before, after);
+            continue;
+        }
+
+        graph.nodes[before].successorCount++;
+        graph.nodes[after].pending++;
+    }
+
+    for (int i = 1; i < count; i++) graph.nodes[i].firstSuccessor = graph.nodes[i - 1].firstSuccessor + graph.nodes[i - 1].successorCount;
+    for (int i = 0; i < count; i++) graph.nodes[i].successorCount = 0;
+
+    for (int i = 0; i < dependencyCount; i++)
+    {
+        int before = dependencies[2*i];
+        int after = dependencies[2*i + 1];
+        if ((before < 0) || (before >= count) || (after < 0) || (after >= count) || (before == after)) continue;
+
+        micGraphNode *node = &graph.nodes[before];
+        graph.successors[node->firstSuccessor + node->successorCount++] = after;
+    }
+
+    // Topological order (ready list used for predecessors left), cycles can not be executed
+    int orderCount = 0;
+
+    for (int i = 0; i < count; i++)
+    {
+        graph.ready[i] = graph.nodes[i].pending;
+        if (graph.nodes[i].pending == 0) order[orderCount++] = i;
+    }
+
+    for (int k = 0; k < orderCount; k++)
+    {
+        const micGraphNode *node = &graph.nodes[order[k]];
+        for (int j = 0; j < node->successorCount; j++)
+        {
+            int next = graph.successors[node->firstSuccessor + j];
+            if (--graph.ready[next] == 0) order[orderCount++] = next;
+        }
+    }
+
+    if (orderCount < count)
+    {
+        micTraceLog(MIC_LOG_WARNING, "Command graph dependencies contain a cycle, no command executed");
+        MIC_FREE(graph.nodes);
+        MIC_FREE(graph.successors);
+        MIC_FREE(graph.ready);
+        MIC_FREE(order);
+        return count;
+    }
+
+    // Commands without history expected to take the average of known ones
+    double knownTime = 0;
+    int knownCount = 0;
+    for (int i = 0; i < count; i++) if (graph.nodes[i].estimate > 0) { knownTime += graph.nodes[i].estimate; knownCount++; }
+
+    double defaultTime = (knownCount > 0)? knownTime/knownCount : 1.0;
+    for (int i = 0; i < count; i++) if (graph.nodes[i].estimate <= 0) graph.nodes[i].estimate = defaultTime;
+
+    // Longest remaining path (bottom level), successors computed first (reverse topological order)
+    for (int k = count - 1; k >= 0; k--)
+    {
+        micGraphNode *node = &graph.nodes[order[k]];
+        double longest = 0;
+
+        for (int j = 0; j < node->successorCount; j++)
+        {
+            double priority = graph.nodes[graph.successors[node->firstSuccessor + j]].priority;
+            if (priority > longest) longest = priority;
+        }
+
+        node->priority = node->estimate + longest;
+    }
+
+    for (int i = 0; i < count; i++) if (graph.nodes[i].pending == 0) graph.ready[graph.readyCount++] = i;
+    graph.remaining = count;
+    graph.lastFinished = -1;
+
+    // NOTE: Concurrency decided by admission control (jobs limit, memory and pressure), one worker per command
+    // at most, workers take next ready command one at a time once previous one has been admitted
+    int workers = ((MIC.Jobs.limit > 0) && (MIC.Jobs.limit < count))? MIC.Jobs.limit : count;
+
+#if !defined(_WIN32)
+    pthread_mutex_init(&graph.mutex, NULL);
+    pthread_cond_init(&graph.condition, NULL);
+#endif
+
+    graph.startTime = micGetTime();
+    micRunParallel(micCommandGraphJob, &graph, workers, workers);
+
+#if !defined(_WIN32)
+    pthread_cond_destroy(&graph.condition);
+    pthread_mutex_destroy(&graph.mutex);
+#endif
+
+    int failed = 0;
+    for (int i = 0; i < count; i++) if (graph.nodes[i].result != 0) failed++;
+
+    // NOTE: Plain commands lists report at debug level, critical path matters with dependencies
+    micReportCriticalPath(&graph, (dependencyCount > 0)? MIC_LOG_INFO : MIC_LOG_DEBUG);
+
+    MIC_FREE(graph.nodes);
+    MIC_FREE(graph.successors);
+    MIC_FREE(graph.ready);
+    MIC_FREE(order);
+
+    return failed;
+}
+
+// Set maximum commands running concurrently (0: effective CPU cores)
+void micSetJobsLimit(int jobs)
+{
+    MIC.Jobs.limit = (jobs > 0)? jobs : 0;
+}
+
+// Declare expected peak memory for a program (overrides learned value)
+// NOTE: program is the executable name without path, i.e. "ld", "xz"
+void micSetCommandMemory(const char *program, long long bytes)
+{
+    if (program == NULL) return;
+
+#if !defined(_WIN32)
+    pthread_mutex_lock(&micJobsMutex);
+#endif
+    micCommandStats *stats = micGetCommandStats(micHashString(program), program, true);
+
+    if (stats != NULL)
+    {
+        stats->peakMemory = bytes;
+        stats->declared = true;
+    }
+#if !defined(_WIN32)
+    pthread_mutex_unlock(&micJobsMutex);
+#endif
+}
+
+// Compile and execute another mic file
+int micExecuteMIC(const char *micFile)
+{
+
+}
+
+// Timming
+//----------------------------------------------------------------------------------
+// [!] Initialize internal timer -> Support multiple timers?
+// NOTE: Timer base is kept in current context, micGetTime() measures from this point
+void micInitTimer(void)
+{
+// Setting a higher resolution can improve the accuracy of time-out intervals in wait functions.
+// However, it can also reduce overall system performance, because the thread scheduler switches tasks more often.
+// High resolutions can also prevent the CPU power management system from entering power-saving modes.
+// Setting a higher resolution does not improve the accuracy of the high-resolution performance counter.
+#if defined(_WIN32) && defined(SUPPORT_WINMM_HIGHRES_TIMER) && !defined(SUPPORT_BUSY_WAIT_LOOP)
+    timeBeginPeriod(1);                 // Setup high-resolution timer to 1ms (granularity of 1-2 ms)
+#endif
+
+    CTX.timeBase += micGetTime();
+}
+
+// Get elapsed time in milliseconds since micInitTimer()
+double micGetTime(void)
+{
+    double time = 0;
+
+#if defined(_WIN32)
+    unsigned long long int clockFrequency, currentTime;
 
     QueryPerformanceFrequency(&clockFrequency);     // BE CAREFUL: Costly operation!
     QueryPerformanceCounter(&currentTime);
@@ -526,7 +2150,7 @@ double micGetTime(void)
     time = ((double)nowTime/1000000.0);     // Time in miliseconds
 #endif
 
-    return time;
+    return time - CTX.timeBase;
 }
 
 // Get current date and time (now)
@@ -544,16 +2168,18 @@ const char *micGetTimeStampString(long timestamp)
 // Wait (sleep) a specific amount of time
 int micWaitTime(int milliseconds)
 {
+    double ms = (double)milliseconds;
+
 #if defined(SUPPORT_BUSY_WAIT_LOOP)
     double previousTime = micGetTime();
     double currentTime = 0.0;
 
     // Busy wait loop
-    while ((currentTime - previousTime) < ms/1000.0f) currentTime = GetTime();
+    while ((currentTime - previousTime) < ms) currentTime = micGetTime();
 #else
     #if defined(SUPPORT_PARTIALBUSY_WAIT_LOOP)
         double busyWait = ms*0.05;     // NOTE: We are using a busy wait of 5% of the time
-        ms -= (float)busyWait;
+        ms -= busyWait;
     #endif
 
     // System halt functions
@@ -565,13 +2191,13 @@ int micWaitTime(int milliseconds)
         time_t sec = (int)(ms/1000.0f);
         ms -= (sec*1000);
         req.tv_sec = sec;
-        req.tv_nsec = ms*1000000L;
+        req.tv_nsec = (long)(ms*1000000.0);
 
         // NOTE: Use nanosleep() on Unix platforms... usleep() it's deprecated.
         while (nanosleep(&req, &req) == -1) continue;
     #endif
     #if defined(__APPLE__)
-        usleep(ms*1000.0f);
+        usleep((useconds_t)(ms*1000.0));
     #endif
 
     #if defined(SUPPORT_PARTIALBUSY_WAIT_LOOP)
@@ -579,11 +2205,326 @@ int micWaitTime(int milliseconds)
         double currentTime = 0.0;
 
         // Partial busy wait loop (only a fraction of the total wait time)
-        while ((currentTime - previousTime) < busyWait/1000.0f) currentTime = micGetTime();
+        while ((currentTime - previousTime) < busyWait) currentTime = micGetTime();
     #endif
 #endif
 }
 
+// Asynchronous execution (event loop)
+//----------------------------------------------------------------------------------
+
+// Launch command without waiting, future result: command exit code (-1 if it could not be launched)
+// NOTE: Command is launched immediately (no admission control), child exit is watched with a pidfd
+// in the event loop (polled with waitpid() on kernels without pidfd), other platforms wait for it here
+micFuture *micExecuteCommandAsync(const char *command, ...)
+{
+    if (command == NULL) return NULL;
+
+    va_list args;
+    va_start(args, command);
+    int length = vsnprintf(NULL, 0, command, args);
+    va_end(args);
+
+    if (length < 0) return NULL;
+
+    char *fullCommand = (char *)MIC_MALLOC(length + 1);
+    if (fullCommand == NULL) return NULL;
+
+    va_start(args, command);
+    vsnprintf(fullCommand, length + 1, command, args);
+    va_end(args);
+
+    micFuture *future = micCreateFuture(MIC_FUTURE_COMMAND, fullCommand);
+    MIC_FREE(fullCommand);
+
+    if (future == NULL) return NULL;
+
+#if defined(__linux__)
+    if (micInitEventLoop())
+    {
+        char *argv[4] = { "/bin/sh", "-c", future->name, NULL };
+        pid_t pid = 0;
+
+        if (posix_spawn(&pid, "/bin/sh", NULL, NULL, argv, environ) != 0)
+        {
+            micTraceLog(MIC_LOG_WARNING, "[%s] Command could not be launched", future->name);
+            micCompleteFuture(future, -1);
+            return future;
+        }
+
+        future->pid = (int)pid;
+#if defined(__NR_pidfd_open)
+        future->fd = (int)syscall(__NR_pidfd_open, pid, 0);
+#endif
+        if (!micWatchFuture(future))
+        {
+            // NOTE: pidfd not supported (kernel < 5.3), child exit is checked at every loop iteration
+            if (future->fd >= 0) close(future->fd);
+            future->fd = -1;
+            CTX.Loop.polledCount++;
+        }
+
+        return future;
+    }
+#endif
+
+    micCompleteFuture(future, micExecuteCommand("%s", future->name));
+
+    return future;
+}
+
+// Start a timer without waiting, future result: 0
+// NOTE: Timer is a timerfd watched by the event loop, other platforms wait for it here
+micFuture *micWaitTimeAsync(int milliseconds)
+{
+    micFuture *future = micCreateFuture(MIC_FUTURE_TIMER, NULL);
+    if (future == NULL) return NULL;
+
+    if (milliseconds < 0) milliseconds = 0;
+
+#if defined(__linux__)
+    if (micInitEventLoop())
+    {
+        struct itimerspec spec = { 0 };
+        spec.it_value.tv_sec = milliseconds/1000;
+        spec.it_value.tv_nsec = (milliseconds%1000)*1000000L + 1;   // NOTE: Zero value would disarm the timer
+
+        future->fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+
+        if ((future->fd >= 0) && (timerfd_settime(future->fd, 0, &spec, NULL) == 0) && micWatchFuture(future)) return future;
+
+        if (future->fd >= 0) close(future->fd);
+        future->fd = -1;
+    }
+#endif
+
+    micWaitTime(milliseconds);
+    micCompleteFuture(future, 0);
+
+    return future;
+}
+
+// Load file data without waiting, future result: 0 on success, -1 on failure
+// NOTE: Data is read with io_uring requests completed in the event loop, if not available the
+// file is loaded here; loaded data is taken from the future with micGetFutureData()
+micFuture *micLoadFileDataAsync(const char *fileName)
+{
+    if (fileName == NULL) return NULL;
+
+    micFuture *future = micCreateFuture(MIC_FUTURE_LOAD, fileName);
+    if (future == NULL) return NULL;
+
+#if defined(MIC_IO_URING_AVAILABLE)
+    if (micInitEventLoop() && (CTX.Loop.ring.fd >= 0) && !CTX.Loop.ringDisabled)
+    {
+        struct stat st = { 0 };
+        future->fd = open(fileName, O_RDONLY | O_CLOEXEC);
+
+        if ((future->fd < 0) || (fstat(future->fd, &st) != 0))
+        {
+            micTraceLog(MIC_LOG_WARNING, "[%s] File could not be opened", fileName);
+            micFinishFileFuture(future, false);
+        }
+        else if ((st.st_size <= 0) || ((unsigned long long)st.st_size > 0xffffffff))
+        {
+            micTraceLog(MIC_LOG_WARNING, "[%s] File size not valid for loading", fileName);
+            micFinishFileFuture(future, false);
+        }
+        else
+        {
+            future->size = (size_t)st.st_size;
+            future->data = (unsigned char *)MIC_MALLOC(future->size);
+
+            if (future->data == NULL) micFinishFileFuture(future, false);
+            else if (!micSubmitFileFuture(future)) micFinishFileFuture(future, micTransferFileFuture(future));
+        }
+
+        return future;
+    }
+#endif
+
+    unsigned int size = 0;
+    future->data = micLoadFileData(fileName, &size);
+    future->size = size;
+
+    micCompleteFuture(future, (future->data != NULL)? 0 : -1);
+
+    return future;
+}
+
+// Save data to file without waiting, future result: 0 on success, -1 on failure
+// NOTE: Data must stay valid until future completes; it is written to a temporary file with io_uring
+// requests (synced as requested by micSetFileSyncMode()) and renamed over fileName, if io_uring
+// is not available the file is saved here
+micFuture *micSaveFileDataAsync(const char *fileName, void *data, unsigned int bytesToWrite)
+{
+    if ((fileName == NULL) || ((data == NULL) && (bytesToWrite > 0))) return NULL;
+
+    micFuture *future = micCreateFuture(MIC_FUTURE_SAVE, fileName);
+    if (future == NULL) return NULL;
+
+#if defined(MIC_IO_URING_AVAILABLE)
+    if (micInitEventLoop() && (CTX.Loop.ring.fd >= 0) && !CTX.Loop.ringDisabled)
+    {
+        char tempFileName[MAX_FILEPATH_LENGTH] = { 0 };
+
+        if (snprintf(tempFileName, MAX_FILEPATH_LENGTH, "%s.XXXXXX", fileName) < MAX_FILEPATH_LENGTH)
+        {
+            future->fd = mkstemp(tempFileName);
+            if (future->fd >= 0) micSetSaveFileMode(future->fd, fileName, false);
+        }
+
+        if (future->fd < 0)
+        {
+            micTraceLog(MIC_LOG_WARNING, "[%s] File could not be opened for writing", fileName);
+            micFinishFileFuture(future, false);
+            return future;
+        }
+
+        future->tempFileName = (char *)MIC_MALLOC(strlen(tempFileName) + 1);
+        if (future->tempFileName != NULL) strcpy(future->tempFileName, tempFileName);
+
+        future->data = (unsigned char *)data;
+        future->size = bytesToWrite;
+
+        if (future->tempFileName == NULL)
+        {
+            unlink(tempFileName);
+            micFinishFileFuture(future, false);
+        }
+        else if ((future->size == 0) || !micSubmitFileFuture(future)) micFinishFileFuture(future, micTransferFileFuture(future));
+
+        return future;
+    }
+#endif
+
+    micCompleteFuture(future, micSaveFileData(fileName, data, bytesToWrite)? 0 : -1);
+
+    return future;
+}
+
+// Attach continuation, called from event loop when future completes
+// NOTE: If future is already completed, continuation is called immediately
+void micThenFuture(micFuture *future, micFutureCallback callback, void *userData)
+{
+    if ((future == NULL) || future->detached) return;
+
+    future->callback = callback;
+    future->userData = userData;
+
+    if (future->ready && (callback != NULL)) callback(future, userData);
+}
+
+// Run event loop until future completes, returns future result
+// NOTE: Continuations of other completed futures are called meanwhile, they must not await futures themselves
+int micAwaitFuture(micFuture *future)
+{
+    if ((future == NULL) || future->detached) return -1;
+
+    while (!future->ready && (CTX.Loop.pendingCount > 0)) micPollEvents(-1);
+
+    return future->ready? future->result : -1;
+}
+
+// Run event loop until all futures complete, returns failed futures count (result not 0)
+int micAwaitFutureList(micFuture **futures, int count)
+{
+    if ((futures == NULL) || (count <= 0)) return 0;
+
+    int failed = 0;
+    for (int i = 0; i < count; i++) if (micAwaitFuture(futures[i]) != 0) failed++;
+
+    return failed;
+}
+
+// Check if future is completed
+bool micIsFutureReady(micFuture *future)
+{
+    return (future != NULL) && future->ready;
+}
+
+// Get completed future result (-1 if pending)
+int micGetFutureResult(micFuture *future)
+{
+    if ((future == NULL) || !future->ready) return -1;
+
+    return future->result;
+}
+
+// Take loaded file data from future (must be freed with micUnloadFileData())
+// NOTE: Data is returned once, future does not own it anymore
+unsigned char *micGetFutureData(micFuture *future, unsigned int *size)
+{
+    if (size != NULL) *size = 0;
+    if ((future == NULL) || !future->ready || (future->type != MIC_FUTURE_LOAD)) return NULL;
+
+    unsigned char *data = future->data;
+    if ((data != NULL) && (size != NULL)) *size = (unsigned int)future->size;
+
+    future->data = NULL;
+    future->size = 0;
+
+    return data;
+}
+
+// Unload future (pending operation continues, future freed when completed)
+void micUnloadFuture(micFuture *future)
+{
+    if ((future == NULL) || future->detached) return;
+
+    if (future->ready) micFreeFuture(future);
+    else future->detached = true;
+}
+
+// Process ready events, waiting up to timeout ms (-1: until one), returns futures completed
+// NOTE: Continuations of completed futures are called from here
+int micPollEvents(int timeout)
+{
+    int completed = CTX.Loop.completedCount;
+
+#if defined(__linux__)
+    if (CTX.Loop.pendingCount == 0) return 0;
+
+    if ((CTX.Loop.polledCount > 0) && ((timeout < 0) || (timeout > LOOP_POLL_INTERVAL))) timeout = LOOP_POLL_INTERVAL;
+
+    struct epoll_event events[MAX_LOOP_EVENTS];
+    int count = epoll_wait(CTX.Loop.epollFd, events, MAX_LOOP_EVENTS, timeout);
+
+    for (int i = 0; i < count; i++)
+    {
+#if defined(MIC_IO_URING_AVAILABLE)
+        if (events[i].data.ptr == &CTX.Loop.ring)
+        {
+            micProcessRingEvents();
+            continue;
+        }
+#endif
+        micFuture *future = (micFuture *)events[i].data.ptr;
+
+        if (future->type == MIC_FUTURE_COMMAND) micReapCommandFuture(future);
+        else if (future->type == MIC_FUTURE_TIMER)
+        {
+            uint64_t expirations = 0;
+            if (read(future->fd, &expirations, sizeof(uint64_t)) == sizeof(uint64_t)) micCompleteFuture(future, 0);
+        }
+    }
+
+    if (CTX.Loop.polledCount > 0)
+    {
+        micFuture *future = CTX.Loop.pending;
+
+        while (future != NULL)
+        {
+            micFuture *next = future->next;
+            if ((future->type == MIC_FUTURE_COMMAND) && (future->fd < 0)) micReapCommandFuture(future);
+            future = next;
+        }
+    }
+#endif
+
+    return CTX.Loop.completedCount - completed;
+}
+
 // File system: Edition
 //----------------------------------------------------------------------------------
 
@@ -640,10 +2581,58 @@ int micRenameFile(const char *fileName, const char *newFileName)
     return result;
 }
 
-// Copy an existing file to a new path and filename
+// Copy an existing file to a new path and filename (or into an existing directory), returns 0 on success
+// NOTE: Destination is replaced atomically, keeping source permissions and modification time;
+// in sync mode (micSetCopyFlags()) an unchanged destination is not written at all
 int micCopyFile(const char *srcFileName, const char *dstPathFileName)
 {
+    struct stat srcInfo = { 0 };
+
+    if ((srcFileName == NULL) || (dstPathFileName == NULL) || (stat(srcFileName, &srcInfo) != 0) || !S_ISREG(srcInfo.st_mode))
+    {
+        micTraceLog(MIC_LOG_WARNING, "[%s] File not available to be copied", (srcFileName != NULL)? srcFileName : "NULL");
+        return -1;
+    }
+
+    // Destination ending with a separator (or existing directory) gets source file name
+    char dstFileName[MAX_FILEPATH_LENGTH] = { 0 };
+    size_t dstLength = strlen(dstPathFileName);
+    bool separator = (dstLength > 0) && IS_PATH_SEPARATOR(dstPathFileName[dstLength - 1]);
+    int length = (separator || micIsDirectoryAvailable(dstPathFileName))?
+        snprintf(dstFileName, MAX_FILEPATH_LENGTH, "%s%s%s", dstPathFileName, separator? "" : "/", micGetFileName(srcFileName)) :
+        snprintf(dstFileName, MAX_FILEPATH_LENGTH, "%s", dstPathFileName);
+
+    if (length >= MAX_FILEPATH_LENGTH)
+    {
+        micTraceLog(MIC_LOG_WARNING, "[%s] File path too long to copy file", dstPathFileName);
+        return -1;
+    }
+
+    // Make sure parent directory exists
+    for (int i = length - 1; i > 0; i--)
+    {
+        if (IS_PATH_SEPARATOR(dstFileName[i]))
+        {
+            char separator = dstFileName[i];
+            dstFileName[i] = '\0';
+            if (!micIsDirectoryAvailable(dstFileName)) micMakeDirectoryTree(dstFileName);
+            dstFileName[i] = separator;
+            break;
+        }
+    }
+
+    long long written = 0;
+    int result = micCopyFileEntry(srcFileName, dstFileName, &srcInfo, &written);
+
+    switch (result)
+    {
+        case MIC_COPY_RESULT_SKIPPED: micTraceLog(MIC_LOG_DEBUG, "[%s] File unchanged, copy skipped", dstFileName); break;
+        case MIC_COPY_RESULT_UPDATED: micTraceLog(MIC_LOG_INFO, "[%s] File updated in place (%lli KB written)", dstFileName, written/1024); break;
+        case MIC_COPY_RESULT_COPIED: micTraceLog(MIC_LOG_INFO, "[%s] File copied successfully", dstFileName); break;
+        default: micTraceLog(MIC_LOG_WARNING, "[%s] File could not be copied", dstFileName); break;
+    }
 
+    return (result == MIC_COPY_RESULT_FAILED)? -1 : 0;
 }
 
 // Move an existing file to a new path and filename
@@ -706,10 +2695,79 @@ int micRenameDirectory(const char *dirPath, const char *newDirPath)
     //int rename (const char *oldname, const char *newname)     // both must be directories, only empty dir can be renamed
 }
 
-// Copy an existing directory to a new path
+// Copy an existing directory to a new path, returns 0 on success (or entries failed count)
+// NOTE: Directories tree created first, then files copied on multiple threads; copy flags
+// (micSetCopyFlags()) allow skipping unchanged files and deleting extraneous destination entries
 int micCopyDirectory(const char *srcDirPath, const char *dstDirPath)
 {
+    if ((srcDirPath == NULL) || (dstDirPath == NULL) || !micIsDirectoryAvailable(srcDirPath))
+    {
+        micTraceLog(MIC_LOG_WARNING, "[%s] Directory not available to be copied", (srcDirPath != NULL)? srcDirPath : "NULL");
+        return -1;
+    }
+
+    // Destination inside source would be copied into itself endlessly
+    const char *srcFullPath = micGetFileFullPath(srcDirPath);
+    const char *dstFullPath = micGetFileFullPath(dstDirPath);
+    size_t srcLength = (srcFullPath != NULL)? strlen(srcFullPath) : 0;
+
+    if ((srcFullPath == NULL) || (dstFullPath == NULL) || ((strncmp(srcFullPath, dstFullPath, srcLength) == 0) &&
+        ((dstFullPath[srcLength] == '\0') || IS_PATH_SEPARATOR(dstFullPath[srcLength]) || IS_PATH_SEPARATOR(srcFullPath[srcLength - 1]))))
+    {
+        micTraceLog(MIC_LOG_WARNING, "[%s] Directory can not be copied into itself", dstDirPath);
+        return -1;
+    }
+
+    double startTime = micGetTime();
+
+    if (!micIsDirectoryAvailable(dstDirPath)) micMakeDirectoryTree(dstDirPath);
+
+    micCopyJobs jobs = { 0 };
+    int failed = micCollectCopyJobs(&jobs, srcDirPath, dstDirPath);
 
+    if (jobs.count > 0)
+    {
+        jobs.results = (int *)MIC_CALLOC(jobs.count, sizeof(int));
+        jobs.written = (long long *)MIC_CALLOC(jobs.count, sizeof(long long));
+
+        if ((jobs.results != NULL) && (jobs.written != NULL)) micRunParallel(micCopyFileJob, &jobs, jobs.count, MAX_IO_THREADS);
+    }
+
+    int copied = 0, updated = 0, skipped = 0, deleted = 0;
+    long long written = 0;
+
+    for (int i = 0; i < jobs.count; i++)
+    {
+        int result = (jobs.results != NULL)? jobs.results[i] : MIC_COPY_RESULT_FAILED;
+
+        if (result == MIC_COPY_RESULT_COPIED) copied++;
+        else if (result == MIC_COPY_RESULT_UPDATED) updated++;
+        else if (result == MIC_COPY_RESULT_SKIPPED) skipped++;
+        else
+        {
+            micTraceLog(MIC_LOG_WARNING, "[%s] File could not be copied", jobs.dstFileNames[i]);
+            failed++;
+        }
+
+        if (jobs.written != NULL) written += jobs.written[i];
+
+        MIC_FREE(jobs.srcFileNames[i]);
+        MIC_FREE(jobs.dstFileNames[i]);
+    }
+
+    MIC_FREE(jobs.srcFileNames);
+    MIC_FREE(jobs.dstFileNames);
+    MIC_FREE(jobs.results);
+    MIC_FREE(jobs.written);
+
+    // Extraneous entries deleted once all files are copied (nothing lost if copy is interrupted)
+    if (CTX.copyFlags & MIC_COPY_DELETE) deleted = micDeleteExtraneousEntries(srcDirPath, dstDirPath, &failed);
+
+    micTraceLog(MIC_LOG_INFO, "[%s] Directory copied: %i files copied, %i updated (%lli KB written), %i unchanged, %i deleted (%.2f ms)",
+        dstDirPath, copied, updated, written/1024, skipped, deleted, micGetTime() - startTime);
+    if (failed > 0) micTraceLog(MIC_LOG_WARNING, "[%s] Directory copy: %i entries failed", dstDirPath, failed);
+
+    return failed;
 }
 
 // Move an existing directory to a new path
@@ -718,8 +2776,14 @@ int micMoveDirectory(const char *srcDirPath, const char *dstDirPath)
 
 }
 
-// File system: Query
-//----------------------------------------------------------------------------------
+// Set copy behaviour for micCopyFile()/micCopyDirectory(): enum micCopyFlags
+void micSetCopyFlags(unsigned int flags)
+{
+    CTX.copyFlags = flags;
+}
+
+// File system: Query
+//----------------------------------------------------------------------------------
 
 // Check if a file exists
 bool micIsFileAvailable(const char *fileName)
@@ -733,18 +2797,27 @@ bool micIsFileAvailable(const char *fileName)
     // ENOENT: This error is reported when a file referenced as a directory component in the file name doesn’t exist, or when a component is a symbolic link whose target file does not exist. See Symbolic Links.
     // ENOTDIR: A file that is referenced as a directory component in the file name exists, but it isn’t a directory.
     // ELOOP: Too many symbolic links were resolved while trying to look up the file name.
+    if (fileName == NULL) return false;
+
+#if defined(_WIN32)
+    return (_access(fileName, 0) == 0);
+#else
+    return (access(fileName, F_OK) == 0);
+#endif
 }
 
 // Check if a directory path exists
 bool micIsDirectoryAvailable(const char *dirPath)
 {
+    struct stat info = { 0 };
 
+    return (dirPath != NULL) && (stat(dirPath, &info) == 0) && S_ISDIR(info.st_mode);
 }
 
 // Get current working directory (uses static string)
 const char *micGetWorkingDirectory(void)
 {
-    static char currentDir[MAX_FILEPATH_LENGTH] = { 0 };
+    char *currentDir = CTX.workingDir;
     memset(currentDir, 0, MAX_FILEPATH_LENGTH);
 
     char *path = GETCWD(currentDir, MAX_FILEPATH_LENGTH - 1);
@@ -758,70 +2831,210 @@ bool micChangeDirectory(const char *dirPath)
 
 }
 
-// Get file size
+// Get file size in bytes
+// NOTE: Returns 0 if file is not available, use micGetFileInfoBatch() for files bigger than 2GB
 int micGetFileSize(const char *fileName)
 {
+    struct stat st = { 0 };
+
+    if ((fileName == NULL) || (stat(fileName, &st) != 0)) return 0;
 
+    return (int)st.st_size;
 }
 
 // Get file modification time (last write time)
 long micGetFileModTime(const char *fileName)
 {
-
+    return micGetFileInfo(fileName, MIC_FILE_INFO_TIME_LAST_WRITE);
 }
 
 // Check file extension (including point: .png, .wav)
+// NOTE: Multiple extensions can be checked at once separated by ';' (".png;.jpg"), case insensitive
 bool micIsFileExtension(const char *fileName, const char *ext)
 {
+    const char *fileExt = micGetFileExtension(fileName);
+    if ((fileExt == NULL) || (ext == NULL)) return false;
+
+    size_t fileExtLength = strlen(fileExt);
 
+    while (*ext != '\0')
+    {
+        const char *end = strchr(ext, ';');
+        size_t length = (end != NULL)? (size_t)(end - ext) : strlen(ext);
+
+        if (length == fileExtLength)
+        {
+            size_t i = 0;
+            while ((i < length) && (TOLOWER_ASCII(ext[i]) == TOLOWER_ASCII(fileExt[i]))) i++;
+            if (i == length) return true;
+        }
+
+        if (end == NULL) break;
+        ext = end + 1;
+    }
+
+    return false;
 }
 
 // Get pointer to extension for a filename string (includes dot: '.png')
+// NOTE: Returns NULL if file name has no extension, a leading dot (".bashrc") is not an extension
 const char *micGetFileExtension(const char *fileName)
 {
+    const char *name = micGetFileName(fileName);
+    if (name == NULL) return NULL;
+
+    const char *dot = strrchr(name, '.');
+    if ((dot == NULL) || (dot == name)) return NULL;
 
+    return dot;
 }
 
 // Get pointer to filename for a path string
 const char *micGetFileName(const char *filePath)
 {
+    if (filePath == NULL) return NULL;
 
+    const char *fileName = filePath;
+    for (const char *c = filePath; *c != '\0'; c++) if (IS_PATH_SEPARATOR(*c)) fileName = c + 1;
+
+    return fileName;
 }
 
-// Get filename string without extension (uses static string)
+// Get filename string without extension (interned string)
 const char *micGetFileNameWithoutExt(const char *filePath)
 {
+    const char *name = micGetFileName(filePath);
+    if (name == NULL) return NULL;
+
+    const char *ext = micGetFileExtension(name);
+    size_t length = (ext != NULL)? (size_t)(ext - name) : strlen(name);
+
+#if !defined(_WIN32)
+    pthread_mutex_lock(&micPathsMutex);
+#endif
+    unsigned int id = micInternPathData(name, length, true);
+#if !defined(_WIN32)
+    pthread_mutex_unlock(&micPathsMutex);
+#endif
 
+    return micGetPathString(id);
 }
 
-// Get full path for a given fileName with path (uses static string)
+// Get directory path for a given fileName with path (interned string)
+// NOTE: Path is normalized first, directory of "file.txt" is "."
 const char *micGetDirectoryPath(const char *filePath)
 {
-
+    return micGetPathString(micGetPathParentId(micInternPath(filePath)));
 }
 
-// Get previous directory path for a given path (uses static string)
+// Get previous directory path for a given path (interned string)
 const char *micGetPrevDirectoryPath(const char *dirPath)
 {
-
+    return micGetPathString(micGetPathParentId(micInternPath(dirPath)));
 }
 
-// Get full path for a file
+// Get full path for a file (interned string)
+// NOTE: Relative paths are resolved against working directory, symbolic links are not followed
 const char *micGetFileFullPath(const char *fileName)
 {
-
+    return micGetPathString(micInternFullPath(fileName));
 }
 
-// Get file path relative to another path
+// Get file path relative to another path (interned string)
+// NOTE: refPath is a directory (working directory if NULL), full path is returned if paths share no root
 const char *micGetFileRelativePath(const char *fileName, const char *refPath)
 {
+    const char *file = micGetPathString(micInternFullPath(fileName));
+    const char *ref = micGetPathString(micInternFullPath((refPath != NULL)? refPath : "."));
+    if ((file == NULL) || (ref == NULL)) return NULL;
+
+    // Common components prefix
+    size_t common = 0;
+    size_t i = 0;
+
+    while ((file[i] != '\0') && (file[i] == ref[i]))
+    {
+        i++;
+        if (file[i - 1] == '/') common = i;
+    }
+
+    if (((file[i] == '\0') || (file[i] == '/')) && ((ref[i] == '\0') || (ref[i] == '/'))) common = i;
+    if (common == 0) return file;
+
+    const char *fileRest = file + common;
+    const char *refRest = ref + common;
+    if (*fileRest == '/') fileRest++;
+    if (*refRest == '/') refRest++;
+
+    // One ".." for every reference component not shared
+    size_t upCount = (*refRest != '\0')? 1 : 0;
+    for (const char *c = refRest; *c != '\0'; c++) if (*c == '/') upCount++;
+
+    size_t length = upCount*3 + strlen(fileRest);
+    char buffer[MAX_FILEPATH_LENGTH] = { 0 };
+    char *relative = (length + 2 <= MAX_FILEPATH_LENGTH)? buffer : (char *)MIC_MALLOC(length + 2);
+    if (relative == NULL) return NULL;
 
+    for (size_t u = 0; u < upCount; u++) memcpy(relative + u*3, "../", 3);
+    strcpy(relative + upCount*3, fileRest);
+
+    const char *result = micGetPathString(micInternPath(relative));
+
+    if (relative != buffer) MIC_FREE(relative);
+
+    return result;
 }
 
-// Get file info: MIC_FILE_INFO_TIME_CREATION, MIC_FILE_INFO_TIME_LAST_ACCESS, MIC_FILE_INFO_TIME_LAST_WRITE
+// Get file time info: enum micFileInfoType
+// NOTE: Times returned in seconds since epoch, 0 if file is not available
 long micGetFileInfo(const char *fileName, int info)
 {
+    struct stat st = { 0 };
+
+    if ((fileName == NULL) || (stat(fileName, &st) != 0)) return 0;
+
+    long time = 0;
+
+    switch (info)
+    {
+#if defined(__APPLE__) || defined(__FreeBSD__)
+        case MIC_FILE_INFO_TIME_CREATION: time = (long)st.st_birthtime; break;
+#else
+        case MIC_FILE_INFO_TIME_CREATION: time = (long)st.st_ctime; break;     // NOTE: Creation time on Windows, status change time on Linux
+#endif
+        case MIC_FILE_INFO_TIME_LAST_ACCESS: time = (long)st.st_atime; break;
+        case MIC_FILE_INFO_TIME_LAST_WRITE: time = (long)st.st_mtime; break;
+        default: break;
+    }
+
+    return time;
+}
+
+// Get metadata for multiple files at once, returns available files count
+// NOTE: On Linux requests are submitted as io_uring STATX operations, if not supported
+// (old kernel, seccomp...) queries are distributed over a pool of worker threads,
+// so latency of network/overlay filesystems overlaps instead of adding up
+int micGetFileInfoBatch(const char **fileNames, int count, micFileInfo *infos)
+{
+    if ((fileNames == NULL) || (infos == NULL) || (count <= 0)) return 0;
+
+    int available = -1;
+
+#if defined(MIC_IO_URING_AVAILABLE)
+    if (count > 1) available = micGetFileInfoBatchRing(fileNames, count, infos);
+#endif
+
+    if (available < 0)
+    {
+        micFileInfoJobs jobs = { fileNames, infos };
+
+        micRunParallel(micGetFileInfoJob, &jobs, count, MAX_IO_THREADS);
 
+        available = 0;
+        for (int i = 0; i < count; i++) if (infos[i].available) available++;
+    }
+
+    return available;
 }
 
 // Get directory byte size (for all files contained)
@@ -836,6 +3049,103 @@ char **micGetDirectoryFiles(const char *dirPath, int *count)
 
 }
 
+// File system: Paths interning
+//----------------------------------------------------------------------------------
+
+// Normalize and intern path, returns path id (0 if path not valid)
+// NOTE: Normalization is lexical: separators collapsed, "." removed, ".." resolved when possible,
+// trailing separator removed; equal normalized paths always get the same id
+unsigned int micInternPath(const char *path)
+{
+    if (path == NULL) return 0;
+
+    return micInternPathJoin(NULL, path, true);
+}
+
+// Get path id of a path already interned (0 if not interned), path is normalized first
+unsigned int micFindPathId(const char *path)
+{
+    if (path == NULL) return 0;
+
+    return micInternPathJoin(NULL, path, false);
+}
+
+// Get interned path string (normalized, valid until micUnloadPaths())
+// NOTE: Returned strings never move, components views (micGetFileName(), micGetFileExtension()) can be kept
+const char *micGetPathString(unsigned int pathId)
+{
+    const micPathEntry *entry = micGetPathEntry(pathId);
+
+    return (entry != NULL)? entry->path : NULL;
+}
+
+// Get interned path length
+unsigned int micGetPathLength(unsigned int pathId)
+{
+    const micPathEntry *entry = micGetPathEntry(pathId);
+
+    return (entry != NULL)? entry->length : 0;
+}
+
+// Get interned path parent directory id (interned if required)
+// NOTE: Parent is lexical: parent of "a" is ".", parent of ".." is "../..", root is its own parent
+unsigned int micGetPathParentId(unsigned int pathId)
+{
+    micPathEntry *entry = micGetPathEntry(pathId);
+    if (entry == NULL) return 0;
+
+#if !defined(_WIN32)
+    pthread_mutex_lock(&micPathsMutex);
+#endif
+    unsigned int parent = entry->parent;
+#if !defined(_WIN32)
+    pthread_mutex_unlock(&micPathsMutex);
+#endif
+
+    if (parent == 0)
+    {
+        parent = micInternPathJoin(entry->path, "..", true);
+
+#if !defined(_WIN32)
+        pthread_mutex_lock(&micPathsMutex);
+#endif
+        entry->parent = parent;
+#if !defined(_WIN32)
+        pthread_mutex_unlock(&micPathsMutex);
+#endif
+    }
+
+    return parent;
+}
+
+// Get interned paths count
+unsigned int micGetPathCount(void)
+{
+    return MIC.Paths.count;
+}
+
+// Unload interned paths (ids and strings not valid anymore)
+void micUnloadPaths(void)
+{
+#if !defined(_WIN32)
+    pthread_mutex_lock(&micPathsMutex);
+#endif
+    if (MIC.Paths.pages != NULL)
+    {
+        for (int i = 0; i < PATH_ENTRIES_MAX_PAGES; i++) MIC_FREE(MIC.Paths.pages[i]);
+        MIC_FREE(MIC.Paths.pages);
+    }
+
+    for (int i = 0; i < MIC.Paths.blockCount; i++) MIC_FREE(MIC.Paths.blocks[i]);
+    MIC_FREE(MIC.Paths.blocks);
+    MIC_FREE(MIC.Paths.table);
+
+    memset(&MIC.Paths, 0, sizeof(MIC.Paths));
+#if !defined(_WIN32)
+    pthread_mutex_unlock(&micPathsMutex);
+#endif
+}
+
 
 // String management (no UTF-8 strings, only byte chars)
 // NOTE: Some strings allocate memory internally for returned strings -> REVIEW
@@ -943,6 +3253,226 @@ bool micStringStartsWith(const char *str, const char *start)
 
 }
 
+// Load multi-pattern replacer: patterns (keys) compiled once into an Aho-Corasick automaton (DFA)
+// NOTE: Matches are leftmost-longest and never overlap, replaced text is not scanned again
+micReplacer *micLoadReplacer(const char **keys, const char **values, int count)
+{
+    if ((keys == NULL) || (values == NULL) || (count <= 0)) return NULL;
+
+    micReplacer *replacer = (micReplacer *)MIC_CALLOC(1, sizeof(micReplacer));
+    if (replacer == NULL) return NULL;
+
+    // Byte classes: bytes used in keys get their own class, all others share class 0
+    int stateCapacity = 1;
+    replacer->classCount = 1;
+
+    for (int i = 0; i < count; i++)
+    {
+        if ((keys[i] == NULL) || (values[i] == NULL)) continue;
+
+        for (const unsigned char *ptr = (const unsigned char *)keys[i]; *ptr != '\0'; ptr++)
+        {
+            if (replacer->classes[*ptr] == 0) replacer->classes[*ptr] = (unsigned char)replacer->classCount++;
+            stateCapacity++;
+        }
+    }
+
+    replacer->next = (int *)MIC_CALLOC((size_t)stateCapacity*replacer->classCount, sizeof(int));
+    replacer->depth = (int *)MIC_CALLOC(stateCapacity, sizeof(int));
+    replacer->matchLength = (int *)MIC_CALLOC(stateCapacity, sizeof(int));
+    replacer->matchValue = (int *)MIC_CALLOC(stateCapacity, sizeof(int));
+    replacer->values = (char **)MIC_CALLOC(count, sizeof(char *));
+    replacer->valueLengths = (int *)MIC_CALLOC(count, sizeof(int));
+    replacer->valueCount = count;
+    int *fail = (int *)MIC_CALLOC(stateCapacity, sizeof(int));
+    int *queue = (int *)MIC_CALLOC(stateCapacity, sizeof(int));
+
+    if ((replacer->next == NULL) || (replacer->depth == NULL) || (replacer->matchLength == NULL) || (replacer->matchValue == NULL) ||
+        (replacer->values == NULL) || (replacer->valueLengths == NULL) || (fail == NULL) || (queue == NULL))
+    {
+        MIC_FREE(fail);
+        MIC_FREE(queue);
+        micUnloadReplacer(replacer);
+        return NULL;
+    }
+
+    // Keys trie (0: no transition, root can not be a transition target)
+    int classCount = replacer->classCount;
+    replacer->stateCount = 1;
+
+    for (int i = 0; i < count; i++)
+    {
+        if ((keys[i] == NULL) || (values[i] == NULL) || (keys[i][0] == '\0')) continue;
+
+        int state = 0;
+
+        for (const unsigned char *ptr = (const unsigned char *)keys[i]; *ptr != '\0'; ptr++)
+        {
+            int *transition = &replacer->next[state*classCount + replacer->classes[*ptr]];
+
+            if (*transition == 0)
+            {
+                *transition = replacer->stateCount;
+                replacer->depth[replacer->stateCount] = replacer->depth[state] + 1;
+                replacer->stateCount++;
+            }
+
+            state = *transition;
+        }
+
+        // Duplicated keys: first one is used
+        if (replacer->matchLength[state] == 0)
+        {
+            size_t length = strlen(values[i]);
+            replacer->values[i] = (char *)MIC_MALLOC(length + 1);
+            if (replacer->values[i] != NULL) memcpy(replacer->values[i], values[i], length + 1);
+
+            replacer->valueLengths[i] = (int)length;
+            replacer->matchLength[state] = replacer->depth[state];
+            replacer->matchValue[state] = i;
+        }
+
+        if (replacer->depth[state] > replacer->maxKeyLength) replacer->maxKeyLength = replacer->depth[state];
+    }
+
+    // Failure links (breadth first), missing transitions filled from failure state: trie becomes a DFA
+    int head = 0;
+    int tail = 0;
+
+    for (int c = 0; c < classCount; c++)
+    {
+        int target = replacer->next[c];
+        if (target != 0) queue[tail++] = target;
+    }
+
+    while (head < tail)
+    {
+        int state = queue[head++];
+
+        // Longest key that is a suffix of this state (if state itself is not a key)
+        if (replacer->matchLength[state] == 0)
+        {
+            replacer->matchLength[state] = replacer->matchLength[fail[state]];
+            replacer->matchValue[state] = replacer->matchValue[fail[state]];
+        }
+
+        for (int c = 0; c < classCount; c++)
+        {
+            int *transition = &replacer->next[state*classCount + c];
+            int fallback = replacer->next[fail[state]*classCount + c];
+
+            if (*transition != 0)
+            {
+                fail[*transition] = fallback;
+                queue[tail++] = *transition;
+            }
+            else *transition = fallback;
+        }
+    }
+
+    MIC_FREE(fail);
+    MIC_FREE(queue);
+
+    micTraceLog(MIC_LOG_DEBUG, "Replacer loaded successfully (%i keys, %i states, %i byte classes)", count, replacer->stateCount, classCount);
+
+    return replacer;
+}
+
+// Unload multi-pattern replacer
+void micUnloadReplacer(micReplacer *replacer)
+{
+    if (replacer == NULL) return;
+
+    if (replacer->values != NULL)
+    {
+        for (int i = 0; i < replacer->valueCount; i++) MIC_FREE(replacer->values[i]);
+    }
+
+    MIC_FREE(replacer->values);
+    MIC_FREE(replacer->valueLengths);
+    MIC_FREE(replacer->next);
+    MIC_FREE(replacer->depth);
+    MIC_FREE(replacer->matchLength);
+    MIC_FREE(replacer->matchValue);
+    MIC_FREE(replacer->output);
+    MIC_FREE(replacer);
+}
+
+// Replace all keys in text (single pass), returns replaced text ('\0' terminated)
+// NOTE: Returned text is owned by the replacer and reused, it is valid until next call
+const char *micReplaceText(micReplacer *replacer, const char *text, int *length)
+{
+    if (length != NULL) *length = 0;
+    if ((replacer == NULL) || (text == NULL)) return NULL;
+
+    replacer->outputSize = 0;
+    micRunReplacer(replacer, (const unsigned char *)text, strlen(text), true);
+
+    if (!micReserveReplacerOutput(replacer, 1)) return NULL;
+    replacer->output[replacer->outputSize] = '\0';
+
+    if (length != NULL) *length = (int)replacer->outputSize;
+
+    return replacer->output;
+}
+
+// Replace all keys in a file into another file (streamed by chunks), returns true on success
+// NOTE: Destination file is replaced once completed (same as micSaveFileData()), it can be the source file
+bool micReplaceFile(micReplacer *replacer, const char *srcFileName, const char *dstFileName)
+{
+    if ((replacer == NULL) || (srcFileName == NULL) || (dstFileName == NULL)) return false;
+
+    FILE *srcFile = fopen(srcFileName, "rb");
+
+    if (srcFile == NULL)
+    {
+        micTraceLog(MIC_LOG_WARNING, "[%s] File could not be opened", srcFileName);
+        return false;
+    }
+
+    micSaveTarget target = { 0 };
+    bool opened = micOpenSaveTarget(&target, dstFileName);
+    size_t capacity = REPLACER_CHUNK_SIZE + replacer->maxKeyLength;
+    unsigned char *chunk = (unsigned char *)MIC_MALLOC(capacity);
+    bool success = opened && (chunk != NULL);
+
+    // Unprocessed tail of every chunk (partial match, up to longest key size) is kept for the next chunk
+    size_t chunkSize = 0;
+    bool final = false;
+
+    while (success && !final)
+    {
+        size_t bytesRead = fread(chunk + chunkSize, 1, capacity - chunkSize, srcFile);
+        chunkSize += bytesRead;
+        final = (bytesRead == 0);
+
+        if (ferror(srcFile)) success = false;
+        else
+        {
+            replacer->outputSize = 0;
+            size_t consumed = micRunReplacer(replacer, chunk, chunkSize, final);
+
+            if (!micWriteSaveTarget(&target, replacer->output, replacer->outputSize)) success = false;
+
+            memmove(chunk, chunk + consumed, chunkSize - consumed);
+            chunkSize -= consumed;
+        }
+    }
+
+    fclose(srcFile);
+    MIC_FREE(chunk);
+
+    // NOTE: Destination keeps its permissions, synced as requested by micSetFileSyncMode()
+    if (opened) success = micCloseSaveTarget(&target, success);
+
+    if (!success)
+    {
+        micTraceLog(MIC_LOG_WARNING, "[%s] File could not be replaced into [%s]", srcFileName, dstFileName);
+    }
+
+    return success;
+}
+
 // Misc functions
 //----------------------------------------------------------------------------------
 
@@ -973,19 +3503,72 @@ void micSetRandomSeed(unsigned int seed)
 // Load file data as byte array (read)
 unsigned char *micLoadFileData(const char *fileName, unsigned int *bytesRead)
 {
+    unsigned char *data = NULL;
+    if (bytesRead != NULL) *bytesRead = 0;
+
+    if (fileName == NULL) return NULL;
+
+    FILE *file = fopen(fileName, "rb");
+
+    if (file != NULL)
+    {
+        fseek(file, 0, SEEK_END);
+        long size = ftell(file);
+        fseek(file, 0, SEEK_SET);
+
+        if ((size > 0) && ((unsigned long)size <= 0xffffffff))
+        {
+            data = (unsigned char *)MIC_MALLOC(size);
+
+            if ((data != NULL) && (fread(data, 1, size, file) == (size_t)size))
+            {
+                if (bytesRead != NULL) *bytesRead = (unsigned int)size;
+                micTraceLog(MIC_LOG_INFO, "[%s] File loaded successfully", fileName);
+            }
+            else
+            {
+                MIC_FREE(data);
+                data = NULL;
+                micTraceLog(MIC_LOG_WARNING, "[%s] File could not be read", fileName);
+            }
+        }
+        else micTraceLog(MIC_LOG_WARNING, "[%s] File size not valid for loading", fileName);
+
+        fclose(file);
+    }
+    else micTraceLog(MIC_LOG_WARNING, "[%s] File could not be opened", fileName);
 
+    return data;
 }
 
 // Unload file data allocated by LoadFileData()
 void micUnloadFileData(unsigned char *data)
 {
-
+    MIC_FREE(data);
 }
 
 // Save data to file from byte array (write), returns true on success
+// NOTE: Data is written to an anonymous (O_TMPFILE) or temporary file that is then renamed
+// over fileName, so readers never see a partially written file
 bool micSaveFileData(const char *fileName, void *data, unsigned int bytesToWrite)
 {
+    if ((fileName == NULL) || ((data == NULL) && (bytesToWrite > 0))) return false;
+
+    micSaveTarget target = { 0 };
 
+    if (!micOpenSaveTarget(&target, fileName))
+    {
+        micTraceLog(MIC_LOG_WARNING, "[%s] File could not be opened for writing", fileName);
+        return false;
+    }
+
+    bool success = micWriteSaveTarget(&target, data, bytesToWrite);
+    success = micCloseSaveTarget(&target, success);
+
+    if (success) micTraceLog(MIC_LOG_INFO, "[%s] File saved successfully", fileName);
+    else micTraceLog(MIC_LOG_WARNING, "[%s] File could not be saved", fileName);
+
+    return success;
 }
 
 // Load text data from file (read), returns a '\0' terminated string
@@ -1003,31 +3586,5996 @@ void micUnloadFileText(char *text)
 // Save text data to file (write), string must be '\0' terminated, returns true on success
 bool micSaveFileText(const char *fileName, char *text)
 {
+    if (text == NULL) return false;
 
+    return micSaveFileData(fileName, text, (unsigned int)strlen(text));
 }
 
-// Compress file into a .zip
-int micZipFile(const char *srcFileName, const char *dstFileName)
+// Set durability mode for saved files: enum micFileSyncMode
+// NOTE: Pending batched writes are synced when leaving MIC_FILE_SYNC_BATCHED mode
+void micSetFileSyncMode(int mode)
 {
+    if ((CTX.syncMode == MIC_FILE_SYNC_BATCHED) && (mode != MIC_FILE_SYNC_BATCHED)) micSyncFiles();
 
+    CTX.syncMode = mode;
 }
 
-// Compress directory into a .zip
-int micZipDirectory(const char *srcPath, const char *dstFileName)
+// Sync pending batched file writes to storage (single barrier), returns true on success
+// NOTE: On Linux a single syncfs() per filesystem replaces one fsync() per saved file
+bool micSyncFiles(void)
+{
+    bool success = true;
+
+#if !defined(_WIN32)
+    pthread_mutex_lock(&micSyncMutex);
+#endif
+
+#if defined(__linux__)
+    for (int i = 0; i < MIC.Sync.count; i++)
+    {
+        if (SYNCFS(MIC.Sync.fds[i]) != 0) success = false;
+        close(MIC.Sync.fds[i]);
+    }
+#elif !defined(_WIN32)
+    for (int i = 0; i < MIC.Sync.count; i++)
+    {
+        int fd = open(MIC.Sync.paths[i], O_RDONLY);
+
+        if ((fd < 0) || (fsync(fd) != 0)) success = false;
+        if (fd >= 0) close(fd);
+
+        MIC_FREE(MIC.Sync.paths[i]);
+    }
+#endif
+
+    if (!success) micTraceLog(MIC_LOG_WARNING, "Saved files could not be synced to storage");
+    else if (MIC.Sync.count > 0) micTraceLog(MIC_LOG_DEBUG, "Saved files synced to storage (%i targets)", MIC.Sync.count);
+
+#if !defined(_WIN32)
+    MIC.Sync.count = 0;
+    pthread_mutex_unlock(&micSyncMutex);
+#endif
+
+    return success;
+}
+
+// Open text file for line by line reading, memory used is constant (file size does not matter)
+// NOTE: Regular files are memory mapped (pages released while reading), gzip files (.gz, detected
+// by content) are decompressed while reading, other files (pipes) are read through a fixed buffer
+micLineReader *micOpenLineReader(const char *fileName)
+{
+    if (fileName == NULL) return NULL;
+
+    FILE *file = fopen(fileName, "rb");
+
+    if (file == NULL)
+    {
+        micTraceLog(MIC_LOG_WARNING, "[%s] File could not be opened", fileName);
+        return NULL;
+    }
+
+    micLineReader *reader = (micLineReader *)MIC_CALLOC(1, sizeof(micLineReader));
+    if (reader == NULL) { fclose(file); return NULL; }
+
+    snprintf(reader->fileName, MAX_FILEPATH_LENGTH, "%s", fileName);
+    reader->file = file;
+
+    unsigned char magic[2] = { 0 };
+    size_t magicSize = fread(magic, 1, 2, file);
+
+    if ((magicSize == 2) && (magic[0] == 0x1f) && (magic[1] == 0x8b))
+    {
+        reader->mode = MIC_LINE_READER_GZIP;
+        reader->input = (unsigned char *)MIC_MALLOC(LINE_READER_INPUT_SIZE);
+        micInitCrc32Table();
+
+        if (reader->input != NULL)
+        {
+            memcpy(reader->input, magic, 2);
+            reader->inflate.src = reader->input;
+            reader->inflate.srcSize = 2;
+        }
+    }
+#if !defined(_WIN32)
+    else
+    {
+        struct stat info = { 0 };
+
+        if ((fstat(fileno(file), &info) == 0) && S_ISREG(info.st_mode) && (info.st_size > 0) && ((unsigned long long)info.st_size <= SIZE_MAX))
+        {
+            void *map = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fileno(file), 0);
+
+            if (map != MAP_FAILED)
+            {
+                madvise(map, (size_t)info.st_size, MADV_SEQUENTIAL);
+
+                reader->mode = MIC_LINE_READER_MAPPED;
+                reader->map = (const unsigned char *)map;
+                reader->mapSize = (size_t)info.st_size;
+
+                fclose(file);
+                reader->file = NULL;
+            }
+        }
+    }
+#endif
+
+    if (reader->mode != MIC_LINE_READER_MAPPED)
+    {
+        reader->buffer = (unsigned char *)MIC_MALLOC(LINE_READER_BUFFER_SIZE);
+
+        if ((reader->buffer == NULL) || ((reader->mode == MIC_LINE_READER_GZIP) && (reader->input == NULL)))
+        {
+            micCloseLineReader(reader);
+            return NULL;
+        }
+
+        if (reader->mode == MIC_LINE_READER_GZIP)
+        {
+            reader->inflate.dst = reader->buffer;
+            reader->inflate.dstCapacity = LINE_READER_BUFFER_SIZE;
+        }
+        else
+        {
+            memcpy(reader->buffer, magic, magicSize);
+            reader->bufferSize = magicSize;
+        }
+    }
+
+    micTraceLog(MIC_LOG_DEBUG, "[%s] Line reader opened (%s)", fileName, (reader->mode == MIC_LINE_READER_MAPPED)? "mapped" : (reader->mode == MIC_LINE_READER_GZIP)? "gzip" : "buffered");
+
+    return reader;
+}
+
+// Read next line, returns NULL at end of file
+// NOTE: Returned line is not '\0' terminated and does not include line ending ("\n" or "\r\n"),
+// it is valid until next read; lines longer than LINE_READER_BUFFER_SIZE are returned in pieces (not mapped files)
+const char *micReadLine(micLineReader *reader, int *length)
+{
+    if (length != NULL) *length = 0;
+    if (reader == NULL) return NULL;
+
+    const unsigned char *line = NULL;
+    size_t lineSize = 0;
+    bool lineEnd = false;
+
+    if (reader->mode == MIC_LINE_READER_MAPPED)
+    {
+#if !defined(_WIN32)
+        if (reader->position >= reader->mapSize) return NULL;
+
+        line = reader->map + reader->position;
+        size_t available = reader->mapSize - reader->position;
+        if (available > 0x7fffffff) available = 0x7fffffff;
+
+        const unsigned char *end = micFindLineEnd(line, available);
+        lineEnd = (end != NULL);
+        lineSize = lineEnd? (size_t)(end - line) : available;
+        reader->position += lineSize + (lineEnd? 1 : 0);
+
+        // Drop pages already read (before current line) so resident memory does not grow with file size
+        size_t lineStart = (size_t)(line - reader->map);
+
+        if ((lineStart - reader->released) >= LINE_READER_RELEASE_SIZE)
+        {
+            size_t pageSize = (size_t)sysconf(_SC_PAGESIZE);
+            size_t releaseEnd = lineStart & ~(pageSize - 1);
+
+            madvise((void *)(reader->map + reader->released), releaseEnd - reader->released, MADV_DONTNEED);
+            reader->released = releaseEnd;
+        }
+#endif
+    }
+    else
+    {
+        if (reader->splitReturn)
+        {
+            // Previous piece was the end of the line if its '\r' is followed by '\n'
+            reader->splitReturn = false;
+            if (((reader->bufferSize - reader->position) < 2) && !reader->eof) micFillLineReader(reader);
+            if (((reader->bufferSize - reader->position) >= 2) && (reader->buffer[reader->position + 1] == '\n')) reader->position += 2;
+        }
+
+        while (true)
+        {
+            size_t available = reader->bufferSize - reader->position;
+            const unsigned char *end = micFindLineEnd(reader->buffer + reader->position + reader->scanned, available - reader->scanned);
+
+            if (end != NULL)
+            {
+                line = reader->buffer + reader->position;
+                lineSize = (size_t)(end - line);
+                lineEnd = true;
+                reader->position += lineSize + 1;
+                reader->scanned = 0;
+                break;
+            }
+
+            reader->scanned = available;
+
+            // Last line (no line ending), or line longer than buffer: returned as it is
+            if (reader->eof || (micFillLineReader(reader) == 0))
+            {
+                if (available == 0) return NULL;
+
+                line = reader->buffer + reader->position;
+                lineSize = available;
+
+                // Line longer than buffer: a last '\r' could start a "\r\n" line ending, kept in buffer
+                if (!reader->eof && (line[lineSize - 1] == '\r'))
+                {
+                    lineSize--;
+                    reader->splitReturn = true;
+                }
+
+                reader->position += lineSize;
+                reader->scanned = 0;
+                break;
+            }
+        }
+    }
+
+    if (lineEnd && (lineSize > 0) && (line[lineSize - 1] == '\r')) lineSize--;
+
+    if (length != NULL) *length = (int)lineSize;
+
+    return (const char *)line;
+}
+
+// Close line reader
+void micCloseLineReader(micLineReader *reader)
 {
+    if (reader == NULL) return;
+
+#if !defined(_WIN32)
+    if (reader->map != NULL) munmap((void *)reader->map, reader->mapSize);
+#endif
+    if (reader->file != NULL) fclose(reader->file);
 
+    MIC_FREE(reader->buffer);
+    MIC_FREE(reader->input);
+    MIC_FREE(reader);
 }
 
-// Compress data (DEFLATE algorithm)
-unsigned char *micCompressData(unsigned char *data, int dataLength, int *compDataLength)
+// Compress file into a .zip
+int micZipFile(const char *srcFileName, const char *dstFileName)
 {
 
 }
 
-// Decompress data (DEFLATE algorithm)
-unsigned char *micDecompressData(unsigned char *compData, int compDataLength, int *dataLength)
+// Compress directory into a .zip
+int micZipDirectory(const char *srcPath, const char *dstFileName)
 {
 
 }
 
+// Load zip archive: central directory is read from the memory mapped file and indexed by name
+// NOTE: Entries data is not read until requested, archive must be unloaded with micUnloadZip()
+micZipArchive micLoadZip(const char *fileName)
+{
+    micZipArchive zip = { 0 };
+
+    if (fileName == NULL) return zip;
+
+    // NOTE: Entries CRC32 verified by extraction jobs, tables initialized before they start
+    micInitCrc32Table();
+
+#if defined(_WIN32)
+    unsigned int dataSize = 0;
+    zip.data = micLoadFileData(fileName, &dataSize);
+    zip.dataSize = dataSize;
+#else
+    int fd = open(fileName, O_RDONLY | O_CLOEXEC);
+
+    if (fd >= 0)
+    {
+        struct stat st = { 0 };
+
+        if ((fstat(fd, &st) == 0) && (st.st_size > 0))
+        {
+            void *data = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+            if (data != MAP_FAILED)
+            {
+                zip.data = (unsigned char *)data;
+                zip.dataSize = (long long)st.st_size;
+            }
+        }
+
+        close(fd);
+    }
+#endif
+
+    if (zip.data == NULL)
+    {
+        micTraceLog(MIC_LOG_WARNING, "[%s] Zip archive could not be opened", fileName);
+        return zip;
+    }
+
+    if (!micParseZipDirectory(&zip))
+    {
+        micTraceLog(MIC_LOG_WARNING, "[%s] Zip archive central directory not valid", fileName);
+        micUnloadZip(zip);
+        micZipArchive empty = { 0 };
+        return empty;
+    }
+
+    micTraceLog(MIC_LOG_INFO, "[%s] Zip archive loaded successfully (%i entries)", fileName, zip.entryCount);
+
+    return zip;
+}
+
+// Unload zip archive data
+void micUnloadZip(micZipArchive zip)
+{
+#if defined(_WIN32)
+    MIC_FREE(zip.data);
+#else
+    if (zip.data != NULL) munmap(zip.data, (size_t)zip.dataSize);
+#endif
+    MIC_FREE(zip.entries);
+    MIC_FREE(zip.names);
+    MIC_FREE(zip.index);
+}
+
+// Get zip entry index by name (no archive scan, hash table lookup), returns -1 if not found
+int micGetZipEntryIndex(micZipArchive zip, const char *name)
+{
+    if ((name == NULL) || (zip.indexSize == 0)) return -1;
+
+    unsigned int mask = (unsigned int)zip.indexSize - 1;
+
+    for (unsigned int slot = (unsigned int)micHashString(name) & mask; zip.index[slot] != 0; slot = (slot + 1) & mask)
+    {
+        int index = zip.index[slot] - 1;
+        if (strcmp(zip.entries[index].name, name) == 0) return index;
+    }
+
+    return -1;
+}
+
+// Load zip entry data by name (memory must be freed with micUnloadFileData())
+unsigned char *micLoadZipEntryData(micZipArchive zip, const char *name, unsigned int *dataSize)
+{
+    if (dataSize != NULL) *dataSize = 0;
+
+    int index = micGetZipEntryIndex(zip, name);
+
+    if (index < 0)
+    {
+        micTraceLog(MIC_LOG_WARNING, "[%s] Zip entry not found", name);
+        return NULL;
+    }
+
+    const micZipEntry *entry = &zip.entries[index];
+    const unsigned char *compData = micGetZipEntryCompData(&zip, entry);
+    if (compData == NULL) return NULL;
+
+    unsigned char *data = (unsigned char *)MIC_MALLOC((entry->size > 0)? (size_t)entry->size : 1);
+    if (data == NULL) return NULL;
+
+    if (!micReadZipEntry(entry, compData, data))
+    {
+        micTraceLog(MIC_LOG_WARNING, "[%s] Zip entry data not valid", name);
+        MIC_FREE(data);
+        return NULL;
+    }
+
+    if (dataSize != NULL) *dataSize = (unsigned int)entry->size;
+
+    return data;
+}
+
+// Extract zip archive into a directory, entries extracted in parallel, returns entries extracted
+int micUnzipFile(const char *srcFileName, const char *dstPath)
+{
+    if (dstPath == NULL) return 0;
+
+    micZipArchive zip = micLoadZip(srcFileName);
+    if (zip.entryCount == 0) return 0;
+
+    micZipOrder *order = (micZipOrder *)MIC_CALLOC(zip.entryCount, sizeof(micZipOrder));
+    int *results = (int *)MIC_CALLOC(zip.entryCount, sizeof(int));
+    int extracted = 0;
+
+    if ((order != NULL) && (results != NULL))
+    {
+        // Biggest entries first, so a big entry does not start last and delay completion
+        for (int i = 0; i < zip.entryCount; i++) order[i] = (micZipOrder){ zip.entries[i].compSize, i };
+        qsort(order, zip.entryCount, sizeof(micZipOrder), micCompareZipOrder);
+
+        micMakeDirectoryTree(dstPath);
+
+        micUnzipJobs jobs = { &zip, dstPath, order, results };
+        micRunParallel(micUnzipEntryJob, &jobs, zip.entryCount, 0);
+
+        for (int i = 0; i < zip.entryCount; i++) if (results[i]) extracted++;
+    }
+
+    if (extracted < zip.entryCount) micTraceLog(MIC_LOG_WARNING, "[%s] Zip archive extracted with errors: %i/%i entries", srcFileName, extracted, zip.entryCount);
+    else micTraceLog(MIC_LOG_INFO, "[%s] Zip archive extracted successfully (%i entries)", srcFileName, extracted);
+
+    MIC_FREE(order);
+    MIC_FREE(results);
+    micUnloadZip(zip);
+
+    return extracted;
+}
+
+// Compute data hash: enum micHashType (multi-threaded for big data)
+micHash micHashData(const void *data, long long size, int type)
+{
+    micHash hash = { 0 };
+
+    if ((size < 0) || ((data == NULL) && (size > 0))) return hash;
+
+    return micHashMemory((const unsigned char *)data, (size_t)size, type, 0);
+}
+
+// Compute file hash: enum micHashType (memory mapped, multi-threaded)
+// NOTE: Returned hash size is 0 if file could not be read
+micHash micHashFile(const char *fileName, int type)
+{
+    micHash hash = micHashFileThreads(fileName, type, 0);
+
+    if (hash.size == 0) micTraceLog(MIC_LOG_WARNING, "[%s] File could not be hashed", fileName);
+
+    return hash;
+}
+
+// Compute multiple files hashes at once, returns files hashed count
+// NOTE: Small files are hashed in parallel (one thread per file), big BLAKE3 files one after another
+// (all threads per file), XXH3 is sequential so all its files are hashed in parallel
+int micHashFileList(const char **fileNames, int count, int type, micHash *hashes)
+{
+    if ((fileNames == NULL) || (hashes == NULL) || (count <= 0)) return 0;
+
+    micFileInfo *infos = (micFileInfo *)MIC_CALLOC(count, sizeof(micFileInfo));
+    int *indices = (int *)MIC_CALLOC(count, sizeof(int));
+
+    if ((infos == NULL) || (indices == NULL))
+    {
+        MIC_FREE(infos);
+        MIC_FREE(indices);
+        return 0;
+    }
+
+    micGetFileInfoBatch(fileNames, count, infos);
+
+    int smallCount = 0;
+    for (int i = 0; i < count; i++)
+    {
+        memset(&hashes[i], 0, sizeof(micHash));
+        if (infos[i].available && ((type != MIC_HASH_BLAKE3) || (infos[i].size <= HASH_BIG_FILE_SIZE))) indices[smallCount++] = i;
+    }
+
+    micHashFiles files = { fileNames, indices, type, 1, hashes };
+    micRunParallel(micHashFileJob, &files, smallCount, 0);
+
+    for (int i = 0; i < count; i++)
+    {
+        if (infos[i].available && (type == MIC_HASH_BLAKE3) && (infos[i].size > HASH_BIG_FILE_SIZE)) hashes[i] = micHashFileThreads(fileNames[i], type, 0);
+    }
+
+    int hashed = 0;
+    for (int i = 0; i < count; i++) if (hashes[i].size > 0) hashed++;
+
+    MIC_FREE(infos);
+    MIC_FREE(indices);
+
+    return hashed;
+}
+
+// Get hash digest as hexadecimal string (uses static string)
+const char *micHashToString(micHash hash)
+{
+    char *buffer = CTX.hashString;
+    memset(buffer, 0, 65);
+
+    for (int i = 0; (i < hash.size) && (i < 32); i++) sprintf(buffer + i*2, "%02x", hash.bytes[i]);
+
+    return buffer;
+}
+
+// Compress data (DEFLATE algorithm)
+// NOTE: Raw DEFLATE stream generated (no zlib/gzip header), memory must be freed with micUnloadFileData()
+unsigned char *micCompressData(unsigned char *data, int dataLength, int *compDataLength)
+{
+    if (compDataLength != NULL) *compDataLength = 0;
+    if ((dataLength < 0) || ((data == NULL) && (dataLength > 0))) return NULL;
+
+    size_t compSize = 0;
+    unsigned char *compData = micDeflate(data, (size_t)dataLength, &compSize);
+
+    // NOTE: Incompressible data grows a few bytes, might not fit an int
+    if ((compData != NULL) && (compSize > 0x7fffffff))
+    {
+        MIC_FREE(compData);
+        compData = NULL;
+    }
+
+    if (compData == NULL) micTraceLog(MIC_LOG_WARNING, "Data could not be compressed");
+    else if (compDataLength != NULL) *compDataLength = (int)compSize;
+
+    return compData;
+}
+
+// Decompress data (DEFLATE algorithm)
+// NOTE: Raw DEFLATE stream expected (no zlib/gzip header), memory must be freed with micUnloadFileData()
+unsigned char *micDecompressData(unsigned char *compData, int compDataLength, int *dataLength)
+{
+    if (dataLength != NULL) *dataLength = 0;
+    if ((compData == NULL) || (compDataLength <= 0)) return NULL;
+
+    micInflateState state = { 0 };
+    state.src = compData;
+    state.srcSize = (size_t)compDataLength;
+    state.growable = true;
+    state.srcFinal = true;
+
+    // Output buffer sized for a typical compression ratio in advance, grown as required
+    state.dst = (unsigned char *)MIC_MALLOC(4*(size_t)compDataLength);
+    if (state.dst != NULL) state.dstCapacity = 4*(size_t)compDataLength;
+
+    if ((micInflate(&state) != MIC_INFLATE_DONE) || (state.dstSize > 0x7fffffff))
+    {
+        micTraceLog(MIC_LOG_WARNING, "Data could not be decompressed");
+        MIC_FREE(state.dst);
+        return NULL;
+    }
+
+    if (dataLength != NULL) *dataLength = (int)state.dstSize;
+
+    return state.dst;
+}
+
+//----------------------------------------------------------------------------------
+// Module internal Functions Definition
+//----------------------------------------------------------------------------------
+#if !defined(_WIN32)
+// Parallel jobs worker thread, processes indices until none left
+static void *micJobsWorker(void *data)
+{
+    micJobs *jobs = (micJobs *)data;
+    micCurrentContext = jobs->context;
+
+    for (int index = __atomic_fetch_add(&jobs->next, 1, __ATOMIC_RELAXED); index < jobs->count;
+         index = __atomic_fetch_add(&jobs->next, 1, __ATOMIC_RELAXED)) jobs->func(jobs->userData, index);
+
+    return NULL;
+}
+#endif
+
+// Run func for [0..count) indices on multiple threads (0 threads: default workers)
+// NOTE: Calling thread also processes jobs, function returns when all indices are processed
+static void micRunParallel(micJobFunc func, void *userData, int count, int threadCount)
+{
+    if (threadCount <= 0) threadCount = micGetWorkerCount();
+    if (threadCount > count) threadCount = count;
+
+#if !defined(_WIN32)
+    if (threadCount > 1)
+    {
+        micJobs jobs = { func, userData, count, 0, micCurrentContext };
+        pthread_t *threads = (pthread_t *)MIC_CALLOC(threadCount - 1, sizeof(pthread_t));
+        int started = 0;
+
+        if (threads != NULL)
+        {
+            for (; started < (threadCount - 1); started++)
+            {
+                if (pthread_create(&threads[started], NULL, micJobsWorker, &jobs) != 0) break;
+            }
+        }
+
+        micJobsWorker(&jobs);
+
+        for (int i = 0; i < started; i++) pthread_join(threads[i], NULL);
+        MIC_FREE(threads);
+
+        return;
+    }
+#endif
+
+    // Single thread (or no threads support)
+    for (int i = 0; i < count; i++) func(userData, i);
+}
+
+// Get default worker threads count for CPU bound jobs
+// NOTE: Effective cores respect cgroup CPU quota, avoiding oversubscription inside containers
+static int micGetWorkerCount(void)
+{
+    return micGetSystemTopology()->effectiveCores;
+}
+
+// Get SIMD instruction sets supported by CPU and OS (CPUID)
+static unsigned int micGetSimdFlags(void)
+{
+    unsigned int flags = 0;
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(_MSC_VER))
+    unsigned int regs[4] = { 0 };   // eax, ebx, ecx, edx
+
+    #if defined(_MSC_VER)
+    __cpuid((int *)regs, 1);
+    #else
+    __get_cpuid(1, &regs[0], &regs[1], &regs[2], &regs[3]);
+    #endif
+
+    if (regs[3] & (1u << 26)) flags |= MIC_SIMD_SSE2;
+    if (regs[2] & (1u << 9)) flags |= MIC_SIMD_SSSE3;
+    if (regs[2] & (1u << 19)) flags |= MIC_SIMD_SSE41;
+    if (regs[2] & (1u << 20)) flags |= MIC_SIMD_SSE42;
+
+    // AVX requires OS support for saving YMM registers (OSXSAVE + XCR0)
+    if ((regs[2] & (1u << 27)) && (regs[2] & (1u << 28)))
+    {
+    #if defined(_MSC_VER)
+        unsigned long long xcr0 = _xgetbv(0);
+    #else
+        unsigned int xcr0Low = 0, xcr0High = 0;
+        __asm__ volatile ("xgetbv" : "=a"(xcr0Low), "=d"(xcr0High) : "c"(0));
+        unsigned long long xcr0 = ((unsigned long long)xcr0High << 32) | xcr0Low;
+    #endif
+
+        if ((xcr0 & 0x6) == 0x6)
+        {
+            flags |= MIC_SIMD_AVX;
+
+            #if defined(_MSC_VER)
+            __cpuidex((int *)regs, 7, 0);
+            #else
+            __get_cpuid_count(7, 0, &regs[0], &regs[1], &regs[2], &regs[3]);
+            #endif
+
+            if (regs[1] & (1u << 5)) flags |= MIC_SIMD_AVX2;
+            if ((regs[1] & (1u << 16)) && ((xcr0 & 0xe6) == 0xe6)) flags |= MIC_SIMD_AVX512F;
+        }
+    }
+#elif defined(__aarch64__) || defined(__ARM_NEON)
+    flags |= MIC_SIMD_NEON;
+#endif
+
+    return flags;
+}
+
+#if defined(__linux__)
+// Read a number from a small system file (sysfs, cgroup)
+static long long micReadFileNumber(const char *fileName, long long defaultValue)
+{
+    long long value = defaultValue;
+    FILE *file = fopen(fileName, "rt");
+
+    if (file != NULL)
+    {
+        if (fscanf(file, "%lli", &value) != 1) value = defaultValue;
+        fclose(file);
+    }
+
+    return value;
+}
+
+// Count CPUs/nodes in a list string: "0-3,8,10-11"
+static int micCountListRange(const char *list)
+{
+    int count = 0;
+    const char *ptr = list;
+
+    while ((*ptr >= '0') && (*ptr <= '9'))
+    {
+        char *end = NULL;
+        long first = strtol(ptr, &end, 10);
+        long last = first;
+
+        if (*end == '-') last = strtol(end + 1, &end, 10);
+        if (last >= first) count += (int)(last - first + 1);
+
+        ptr = end;
+        if (*ptr == ',') ptr++;
+    }
+
+    return count;
+}
+
+// Get cgroup (v2 or v1) CPU quota, memory limit and usage file
+// NOTE: cgroup v2 hierarchy is walked up to the root, most restrictive limit is kept
+static void micGetCgroupLimits(float *cpuQuota, long long *memoryLimit, char *memoryUsageFile)
+{
+    *cpuQuota = 0.0f;
+    *memoryLimit = 0;
+    memoryUsageFile[0] = '\0';
+
+    char cgroupPath[MAX_FILEPATH_LENGTH] = { 0 };       // cgroup v2 path ("0::" entry)
+    char cpuPath[MAX_FILEPATH_LENGTH] = { 0 };          // cgroup v1 cpu controller path
+    char memoryPath[MAX_FILEPATH_LENGTH] = { 0 };       // cgroup v1 memory controller path
+    char line[MAX_FILEPATH_LENGTH] = { 0 };
+
+    FILE *file = fopen("/proc/self/cgroup", "rt");
+    if (file == NULL) return;
+
+    while (fgets(line, MAX_FILEPATH_LENGTH, file) != NULL)
+    {
+        line[strcspn(line, "\n")] = '\0';
+
+        char *controllers = strchr(line, ':');
+        char *path = (controllers != NULL)? strchr(controllers + 1, ':') : NULL;
+        if (path == NULL) continue;
+        *path = '\0';
+        controllers++;
+        path++;
+
+        if (controllers[0] == '\0') snprintf(cgroupPath, MAX_FILEPATH_LENGTH, "%s", path);
+        else
+        {
+            // Controllers list could be combined: "cpu,cpuacct"
+            char *token = strtok(controllers, ",");
+            while (token != NULL)
+            {
+                if (strcmp(token, "cpu") == 0) snprintf(cpuPath, MAX_FILEPATH_LENGTH, "%s", path);
+                else if (strcmp(token, "memory") == 0) snprintf(memoryPath, MAX_FILEPATH_LENGTH, "%s", path);
+                token = strtok(NULL, ",");
+            }
+        }
+    }
+
+    fclose(file);
+
+    char fileName[MAX_FILEPATH_LENGTH + 64] = { 0 };
+    char usageFile[MAX_FILEPATH_LENGTH] = { 0 };
+
+    if (micIsFileAvailable("/sys/fs/cgroup/cgroup.controllers"))
+    {
+        // cgroup v2 (unified hierarchy)
+        size_t length = strlen(cgroupPath);
+
+        while (true)
+        {
+            snprintf(fileName, sizeof(fileName), "/sys/fs/cgroup%s/cpu.max", cgroupPath);
+            file = fopen(fileName, "rt");
+            if (file != NULL)
+            {
+                long long quota = 0, period = 0;
+                if ((fscanf(file, "%lli %lli", &quota, &period) == 2) && (quota > 0) && (period > 0))
+                {
+                    float cores = (float)quota/(float)period;
+                    if ((*cpuQuota == 0.0f) || (cores < *cpuQuota)) *cpuQuota = cores;
+                }
+                fclose(file);
+            }
+
+            // NOTE: "max" value is not parsed as a number, meaning no limit
+            snprintf(fileName, sizeof(fileName), "/sys/fs/cgroup%s/memory.max", cgroupPath);
+            long long limit = micReadFileNumber(fileName, 0);
+
+            // NOTE: Limits with a usage file path that does not fit are skipped (usage could not be followed)
+            if ((limit > 0) && ((*memoryLimit == 0) || (limit < *memoryLimit)) &&
+                (snprintf(usageFile, MAX_FILEPATH_LENGTH, "/sys/fs/cgroup%s/memory.current", cgroupPath) < MAX_FILEPATH_LENGTH))
+            {
+                *memoryLimit = limit;
+                strcpy(memoryUsageFile, usageFile);
+            }
+
+            // Move to parent cgroup
+            if ((length == 0) || ((length == 1) && (cgroupPath[0] == '/'))) break;
+            while ((length > 0) && (cgroupPath[length - 1] != '/')) length--;
+            if (length > 1) length--;
+            cgroupPath[length] = '\0';
+        }
+    }
+    else
+    {
+        // cgroup v1: controller path could be hidden by cgroup namespace, try also the mount root
+        const char *cpuDirs[2] = { cpuPath, "" };
+        const char *memoryDirs[2] = { memoryPath, "" };
+
+        for (int i = 0; i < 2; i++)
+        {
+            snprintf(fileName, sizeof(fileName), "/sys/fs/cgroup/cpu%s/cpu.cfs_quota_us", cpuDirs[i]);
+            long long quota = micReadFileNumber(fileName, -1);
+            snprintf(fileName, sizeof(fileName), "/sys/fs/cgroup/cpu%s/cpu.cfs_period_us", cpuDirs[i]);
+            long long period = micReadFileNumber(fileName, -1);
+
+            if ((quota > 0) && (period > 0)) { *cpuQuota = (float)quota/(float)period; break; }
+        }
+
+        for (int i = 0; i < 2; i++)
+        {
+            snprintf(fileName, sizeof(fileName), "/sys/fs/cgroup/memory%s/memory.limit_in_bytes", memoryDirs[i]);
+            long long limit = micReadFileNumber(fileName, -1);
+
+            // NOTE: Unlimited is reported as a huge page-aligned value (LONG_MAX rounded)
+            if ((limit > 0) && (limit < (1LL << 62)) &&
+                (snprintf(usageFile, MAX_FILEPATH_LENGTH, "/sys/fs/cgroup/memory%s/memory.usage_in_bytes", memoryDirs[i]) < MAX_FILEPATH_LENGTH))
+            {
+                *memoryLimit = limit;
+                strcpy(memoryUsageFile, usageFile);
+                break;
+            }
+        }
+    }
+}
+#endif
+
+// Compute string hash (FNV-1a), used for commands keys
+static unsigned long long micHashString(const char *str)
+{
+    unsigned long long hash = 0xcbf29ce484222325ULL;
+
+    for (const unsigned char *ptr = (const unsigned char *)str; *ptr != '\0'; ptr++)
+    {
+        hash ^= *ptr;
+        hash *= 0x100000001b3ULL;
+    }
+
+    return hash;
+}
+
+// Get program name (first token, no path) from a command line
+static void micGetProgramName(const char *command, char *name, int size)
+{
+    while ((*command == ' ') || (*command == '\t')) command++;
+
+    const char *start = command;
+    const char *end = command;
+
+    for (; (*end != '\0') && (*end != ' ') && (*end != '\t'); end++)
+    {
+        if ((*end == '/') || (*end == '\\')) start = end + 1;
+    }
+
+    int length = (int)(end - start);
+    if (length > (size - 1)) length = size - 1;
+
+    memcpy(name, start, length);
+    name[length] = '\0';
+}
+
+// Get command data entry (create if required)
+// NOTE: Requires micJobsMutex locked
+static micCommandStats *micGetCommandStats(unsigned long long key, const char *name, bool create)
+{
+    for (int i = 0; i < MIC.Jobs.statsCount; i++) if (MIC.Jobs.stats[i].key == key) return &MIC.Jobs.stats[i];
+
+    if (!create) return NULL;
+
+    if (MIC.Jobs.statsCount >= MIC.Jobs.statsCapacity)
+    {
+        int capacity = (MIC.Jobs.statsCapacity == 0)? 64 : MIC.Jobs.statsCapacity*2;
+        micCommandStats *stats = (micCommandStats *)MIC_REALLOC(MIC.Jobs.stats, capacity*sizeof(micCommandStats));
+        if (stats == NULL) return NULL;
+
+        MIC.Jobs.stats = stats;
+        MIC.Jobs.statsCapacity = capacity;
+    }
+
+    micCommandStats *stats = &MIC.Jobs.stats[MIC.Jobs.statsCount++];
+    memset(stats, 0, sizeof(micCommandStats));
+    stats->key = key;
+    snprintf(stats->name, 64, "%s", name);
+    for (char *ptr = stats->name; *ptr != '\0'; ptr++) if ((*ptr == '\n') || (*ptr == '\r')) *ptr = ' ';
+
+    return stats;
+}
+
+// Get expected peak memory for a command (0 if unknown)
+// NOTE: Priority: program declared value, exact command line learned value, program learned value
+static long long micGetCommandMemoryEstimate(const char *command)
+{
+    char program[64] = { 0 };
+    micGetProgramName(command, program, 64);
+
+    long long estimate = 0;
+
+#if !defined(_WIN32)
+    pthread_mutex_lock(&micJobsMutex);
+#endif
+    micLoadCommandStats();
+
+    micCommandStats *programStats = micGetCommandStats(micHashString(program), program, false);
+    micCommandStats *commandStats = micGetCommandStats(micHashString(command), command, false);
+
+    if ((programStats != NULL) && programStats->declared) estimate = programStats->peakMemory;
+    else if (commandStats != NULL) estimate = commandStats->peakMemory;
+    else if (programStats != NULL) estimate = programStats->peakMemory;
+#if !defined(_WIN32)
+    pthread_mutex_unlock(&micJobsMutex);
+#endif
+
+    return estimate;
+}
+
+// Get expected duration for a command in milliseconds (0 if unknown)
+// NOTE: Priority: exact command line learned value, program learned value
+static double micGetCommandDurationEstimate(const char *command)
+{
+    char program[64] = { 0 };
+    micGetProgramName(command, program, 64);
+
+    double estimate = 0;
+
+#if !defined(_WIN32)
+    pthread_mutex_lock(&micJobsMutex);
+#endif
+    micLoadCommandStats();
+
+    micCommandStats *commandStats = micGetCommandStats(micHashString(command), command, false);
+    micCommandStats *programStats = micGetCommandStats(micHashString(program), program, false);
+
+    if ((commandStats != NULL) && (commandStats->duration > 0)) estimate = commandStats->duration;
+    else if (programStats != NULL) estimate = programStats->duration;
+#if !defined(_WIN32)
+    pthread_mutex_unlock(&micJobsMutex);
+#endif
+
+    return estimate;
+}
+
+// Learn command peak memory and duration from a run (0: not measured)
+// NOTE: Memory growth is learned immediately, decrease slowly: estimates should not under-predict,
+// duration is averaged with previous runs (recent runs weigh more)
+static void micUpdateCommandStats(const char *command, long long peakMemory, double duration)
+{
+    char program[64] = { 0 };
+    micGetProgramName(command, program, 64);
+
+    const char *names[2] = { command, program };
+
+#if !defined(_WIN32)
+    pthread_mutex_lock(&micJobsMutex);
+#endif
+    micLoadCommandStats();
+
+    for (int i = 0; i < 2; i++)
+    {
+        micCommandStats *stats = micGetCommandStats(micHashString(names[i]), names[i], true);
+        if ((stats == NULL) || stats->declared) continue;
+
+        if (peakMemory > stats->peakMemory) stats->peakMemory = peakMemory;
+        else if (peakMemory > 0) stats->peakMemory = (3*stats->peakMemory + peakMemory)/4;
+
+        if (duration > 0) stats->duration = (stats->duration > 0)? (stats->duration + duration)/2 : duration;
+    }
+
+    MIC.Jobs.statsChanged = true;
+#if !defined(_WIN32)
+    pthread_mutex_unlock(&micJobsMutex);
+#endif
+}
+
+// Learn step duration from a run, returns previous expected duration (0 if unknown)
+// NOTE: Steps are kept with commands data, named "[step] <description>"
+static double micUpdateStepStats(const char *description, double duration)
+{
+    char name[80] = { 0 };
+    snprintf(name, 80, "[step] %s", description);
+
+    double expected = 0;
+
+#if !defined(_WIN32)
+    pthread_mutex_lock(&micJobsMutex);
+#endif
+    micLoadCommandStats();
+
+    micCommandStats *stats = micGetCommandStats(micHashString(name), name, true);
+
+    if (stats != NULL)
+    {
+        expected = stats->duration;
+        stats->duration = (stats->duration > 0)? (stats->duration + duration)/2 : duration;
+        MIC.Jobs.statsChanged = true;
+    }
+#if !defined(_WIN32)
+    pthread_mutex_unlock(&micJobsMutex);
+#endif
+
+    return expected;
+}
+
+// Load learned commands data from history file
+// NOTE: Requires micJobsMutex locked, history file line format: <key> <peakMemory> <duration> <name>,
+// after a version line. Files without version line use previous format: <key> <peakMemory> <name>
+static void micLoadCommandStats(void)
+{
+    if (MIC.Jobs.statsLoaded) return;
+    MIC.Jobs.statsLoaded = true;
+
+    FILE *file = fopen(MIC_COMMANDS_HISTORY_FILE, "rt");
+    if (file == NULL) return;
+
+    char line[256] = { 0 };
+    int version = 1;
+
+    while (fgets(line, 256, file) != NULL)
+    {
+        unsigned long long key = 0;
+        long long peakMemory = 0;
+        double duration = 0;
+        int offset = 0;
+
+        if (line[0] == '#')
+        {
+            if (sscanf(line, "# mic commands history v%i", &version) < 1) version = 1;
+            continue;
+        }
+
+        // NOTE: Previous format lines (no duration) are accepted, duration is learned again
+        if (version >= 2)
+        {
+            if (sscanf(line, "%llx %lli %lf %n", &key, &peakMemory, &duration, &offset) < 3) continue;
+            if (!((duration >= 0) && (duration < 1e12))) duration = 0;
+        }
+        else if (sscanf(line, "%llx %lli %n", &key, &peakMemory, &offset) < 2) continue;
+
+        line[strcspn(line, "\n")] = '\0';
+
+        micCommandStats *stats = micGetCommandStats(key, line + offset, true);
+
+        if ((stats != NULL) && !stats->declared)
+        {
+            stats->peakMemory = peakMemory;
+            stats->duration = duration;
+        }
+    }
+
+    fclose(file);
+}
+
+// Save learned commands data to history file (if changed)
+static void micSaveCommandStats(void)
+{
+#if !defined(_WIN32)
+    pthread_mutex_lock(&micJobsMutex);
+#endif
+    if (MIC.Jobs.statsChanged)
+    {
+        // NOTE: Line max size: 16 (key) + 20 (memory) + 24 (duration) + 64 (name) + separators, after version line
+        char *text = (char *)MIC_CALLOC(MIC.Jobs.statsCount*136 + 32, 1);
+
+        if (text != NULL)
+        {
+            int length = sprintf(text, "# mic commands history v2\n");
+
+            for (int i = 0; i < MIC.Jobs.statsCount; i++)
+            {
+                micCommandStats *stats = &MIC.Jobs.stats[i];
+                if (!stats->declared) length += sprintf(text + length, "%016llx %lli %.3f %s\n", stats->key, stats->peakMemory, stats->duration, stats->name);
+            }
+
+            if (micSaveFileData(MIC_COMMANDS_HISTORY_FILE, text, length)) MIC.Jobs.statsChanged = false;
+            MIC_FREE(text);
+        }
+    }
+#if !defined(_WIN32)
+    pthread_mutex_unlock(&micJobsMutex);
+#endif
+}
+
+#if !defined(_WIN32)
+// Wait until system state allows launching a command, returns running slot
+// NOTE: Running commands reserve their estimate minus their current resident memory,
+// a command is always admitted when nothing else is running (no deadlock on big estimates)
+static int micAdmitCommand(long long estimate)
+{
+    pthread_mutex_lock(&micJobsMutex);
+
+    int limit = (MIC.Jobs.limit > 0)? MIC.Jobs.limit : micGetWorkerCount();
+    bool heldBack = false;
+
+    while (MIC.Jobs.running > 0)
+    {
+        bool admit = (MIC.Jobs.running < limit);
+
+        if (admit)
+        {
+            // Memory still to be claimed by running commands
+            long long pending = estimate;
+            long pageSize = sysconf(_SC_PAGESIZE);
+
+            for (int i = 0; i < MIC.Jobs.capacity; i++)
+            {
+                micRunningCommand *running = &MIC.Jobs.commands[i];
+                if (!running->active) continue;
+
+                long long resident = 0;
+#if defined(__linux__)
+                if (running->pid > 0)
+                {
+                    char fileName[64] = { 0 };
+                    snprintf(fileName, 64, "/proc/%i/statm", running->pid);
+
+                    FILE *file = fopen(fileName, "rt");
+                    if (file != NULL)
+                    {
+                        long long pages = 0;
+                        if (fscanf(file, "%*s %lli", &pages) == 1) resident = pages*pageSize;
+                        fclose(file);
+                    }
+                }
+#endif
+                if (running->estimate > resident) pending += running->estimate - resident;
+            }
+
+            long long available = micGetAvailableMemory();
+
+            if ((available > 0) && (pending > (long long)(available*MEMORY_ADMISSION_FACTOR))) admit = false;
+            else if (micGetPressure("/proc/pressure/memory") > MEMORY_PRESSURE_LIMIT) admit = false;
+            else if (micGetPressure("/proc/pressure/cpu") > CPU_PRESSURE_LIMIT) admit = false;
+        }
+
+        if (admit) break;
+
+        if (!heldBack) micTraceLog(MIC_LOG_DEBUG, "Command held back: %i running, expected peak memory %lli KB", MIC.Jobs.running, estimate/1024);
+        heldBack = true;
+
+        // NOTE: Pressure and memory change without commands finishing, re-check periodically
+        struct timespec timeout = { 0 };
+        clock_gettime(CLOCK_REALTIME, &timeout);
+        timeout.tv_nsec += 100*1000000L;
+        if (timeout.tv_nsec >= 1000000000L) { timeout.tv_sec++; timeout.tv_nsec -= 1000000000L; }
+
+        pthread_cond_timedwait(&micJobsCondition, &micJobsMutex, &timeout);
+    }
+
+    // Find a free running slot
+    int slot = -1;
+    for (int i = 0; i < MIC.Jobs.capacity; i++) if (!MIC.Jobs.commands[i].active) { slot = i; break; }
+
+    if (slot < 0)
+    {
+        int capacity = (MIC.Jobs.capacity == 0)? 16 : MIC.Jobs.capacity*2;
+        micRunningCommand *commands = (micRunningCommand *)MIC_REALLOC(MIC.Jobs.commands, capacity*sizeof(micRunningCommand));
+
+        if (commands != NULL)
+        {
+            memset(commands + MIC.Jobs.capacity, 0, (capacity - MIC.Jobs.capacity)*sizeof(micRunningCommand));
+            slot = MIC.Jobs.capacity;
+            MIC.Jobs.commands = commands;
+            MIC.Jobs.capacity = capacity;
+        }
+    }
+
+    if (slot >= 0)
+    {
+        MIC.Jobs.commands[slot].active = true;
+        MIC.Jobs.commands[slot].pid = 0;
+        MIC.Jobs.commands[slot].estimate = estimate;
+    }
+
+    MIC.Jobs.running++;
+
+    pthread_mutex_unlock(&micJobsMutex);
+
+    return slot;
+}
+
+// Release running slot, wake up held back commands
+static void micReleaseCommand(int slot)
+{
+    pthread_mutex_lock(&micJobsMutex);
+
+    if (slot >= 0) MIC.Jobs.commands[slot].active = false;
+    MIC.Jobs.running--;
+
+    pthread_cond_broadcast(&micJobsCondition);
+    pthread_mutex_unlock(&micJobsMutex);
+}
+
+// Get memory available for new commands (system and cgroup)
+// NOTE: Returns 0 if unknown
+static long long micGetAvailableMemory(void)
+{
+    long long available = 0;
+
+#if defined(__linux__)
+    FILE *file = fopen("/proc/meminfo", "rt");
+
+    if (file != NULL)
+    {
+        char line[128] = { 0 };
+
+        while (fgets(line, 128, file) != NULL)
+        {
+            if (sscanf(line, "MemAvailable: %lli kB", &available) == 1) { available *= 1024; break; }
+        }
+
+        fclose(file);
+    }
+
+    const micSystemTopology *topology = micGetSystemTopology();
+
+    if ((topology->memoryLimit > 0) && (MIC.memoryUsageFile[0] != '\0'))
+    {
+        long long usage = micReadFileNumber(MIC.memoryUsageFile, 0);
+        long long cgroupAvailable = topology->memoryLimit - usage;
+        if (cgroupAvailable < 0) cgroupAvailable = 1;
+
+        if ((available == 0) || (cgroupAvailable < available)) available = cgroupAvailable;
+    }
+#endif
+
+    return available;
+}
+
+// Get pressure stall information: "some avg10" percentage
+// NOTE: Returns 0.0f if PSI is not available (kernel < 4.20, not Linux)
+static float micGetPressure(const char *fileName)
+{
+    float pressure = 0.0f;
+    FILE *file = fopen(fileName, "rt");
+
+    if (file != NULL)
+    {
+        if (fscanf(file, "some avg10=%f", &pressure) != 1) pressure = 0.0f;
+        fclose(file);
+    }
+
+    return pressure;
+}
+
+// Spawn shell command and wait, returns exit code
+static int micRunCommand(const char *command, int slot, long long *peakMemory)
+{
+    char *argv[4] = { "/bin/sh", "-c", (char *)command, NULL };
+    pid_t pid = 0;
+
+    if (posix_spawn(&pid, "/bin/sh", NULL, NULL, argv, environ) != 0)
+    {
+        micTraceLog(MIC_LOG_WARNING, "[%s] Command could not be launched", command);
+        return -1;
+    }
+
+    if (slot >= 0)
+    {
+        pthread_mutex_lock(&micJobsMutex);
+        MIC.Jobs.commands[slot].pid = (int)pid;
+        pthread_mutex_unlock(&micJobsMutex);
+    }
+
+    int status = 0;
+    struct rusage usage = { 0 };
+
+    while (wait4(pid, &status, 0, &usage) < 0)
+    {
+        if (errno != EINTR) return -1;
+    }
+
+#if defined(__APPLE__)
+    *peakMemory = (long long)usage.ru_maxrss;         // NOTE: Bytes on macOS
+#else
+    *peakMemory = (long long)usage.ru_maxrss*1024;    // NOTE: Kilobytes on Linux/BSD
+#endif
+
+    if (WIFEXITED(status)) return WEXITSTATUS(status);
+    if (WIFSIGNALED(status)) return 128 + WTERMSIG(status);
+
+    return -1;
+}
+
+// Run an admitted command in its running slot, learns its peak memory and duration, returns exit code
+// NOTE: Running slot is released by caller (graph state updated before next command is admitted)
+static int micRunAdmittedCommand(const char *command, int slot)
+{
+    long long peakMemory = 0;
+
+    double startTime = micGetTime();
+    int result = micRunCommand(command, slot, &peakMemory);
+    double elapsedTime = micGetTime() - startTime;
+
+    // NOTE: Failed commands duration is not learned (usually they stop early)
+    if ((peakMemory > 0) || (result == 0)) micUpdateCommandStats(command, peakMemory, (result == 0)? elapsedTime : 0);
+
+    micTraceLog(MIC_LOG_DEBUG, "[%s] Command finished: exit code %i, %.2f ms, peak memory %lli KB", command, result, elapsedTime, peakMemory/1024);
+
+    return result;
+}
+#endif
+
+// Execute graph commands as they become ready, longest remaining path first (job for micRunParallel())
+// NOTE: Every worker runs one command at a time, until all graph commands are finished. Workers take
+// next ready command once previous one is admitted, held back commands are launched in priority order
+static void micCommandGraphJob(void *userData, int index)
+{
+    micCommandGraph *graph = (micCommandGraph *)userData;
+    (void)index;
+
+#if !defined(_WIN32)
+    pthread_mutex_lock(&graph->mutex);
+#endif
+    while (graph->remaining > 0)
+    {
+        if ((graph->readyCount == 0) || graph->admitting)
+        {
+#if !defined(_WIN32)
+            pthread_cond_wait(&graph->condition, &graph->mutex);
+            continue;
+#else
+            break;
+#endif
+        }
+
+        // Ready command with longest remaining path, graph order on ties
+        int best = 0;
+        for (int i = 1; i < graph->readyCount; i++)
+        {
+            const micGraphNode *candidate = &graph->nodes[graph->ready[i]];
+            const micGraphNode *current = &graph->nodes[graph->ready[best]];
+
+            if ((candidate->priority > current->priority) || ((candidate->priority == current->priority) && (graph->ready[i] < graph->ready[best]))) best = i;
+        }
+
+        int nodeIndex = graph->ready[best];
+        micGraphNode *node = &graph->nodes[nodeIndex];
+        graph->ready[best] = graph->ready[--graph->readyCount];
+
+        if (node->blocked)
+        {
+            node->startTime = micGetTime();
+            node->endTime = node->startTime;
+            micTraceLog(MIC_LOG_WARNING, "[%s] Command not executed, a command it depends on failed", node->command);
+        }
+        else
+        {
+            double readyTime = (node->gate >= 0)? graph->nodes[node->gate].endTime : graph->startTime;
+#if !defined(_WIN32)
+            graph->admitting = true;
+            pthread_mutex_unlock(&graph->mutex);
+
+            int slot = micAdmitCommand(micGetCommandMemoryEstimate(node->command));
+
+            pthread_mutex_lock(&graph->mutex);
+            graph->admitting = false;
+            pthread_cond_broadcast(&graph->condition);
+#endif
+            node->startTime = micGetTime();
+
+            // Started later than ready: command finished last freed the running slot (or the worker)
+            if ((graph->lastFinished >= 0) && (graph->nodes[graph->lastFinished].endTime > readyTime)) node->gate = graph->lastFinished;
+#if !defined(_WIN32)
+            pthread_mutex_unlock(&graph->mutex);
+
+            node->result = micRunAdmittedCommand(node->command, slot);
+            if (node->result != 0) micTraceLog(MIC_LOG_WARNING, "[%s] Command failed with exit code %i", node->command, node->result);
+
+            pthread_mutex_lock(&graph->mutex);
+            node->endTime = micGetTime();
+            graph->lastFinished = nodeIndex;
+            micReleaseCommand(slot);
+#else
+            node->result = micExecuteCommand("%s", node->command);
+            node->endTime = micGetTime();
+            graph->lastFinished = nodeIndex;
+#endif
+        }
+
+        for (int j = 0; j < node->successorCount; j++)
+        {
+            micGraphNode *next = &graph->nodes[graph->successors[node->firstSuccessor + j]];
+            if (node->result != 0) next->blocked = true;
+
+            if (--next->pending == 0)
+            {
+                next->gate = nodeIndex;
+                graph->ready[graph->readyCount++] = graph->successors[node->firstSuccessor + j];
+            }
+        }
+
+        graph->remaining--;
+#if !defined(_WIN32)
+        pthread_cond_broadcast(&graph->condition);
+#endif
+    }
+#if !defined(_WIN32)
+    pthread_mutex_unlock(&graph->mutex);
+#endif
+}
+
+// Log predicted and actual critical path of an executed command graph
+// NOTE: Predicted path follows longest remaining paths from graph start, actual path goes back from last
+// finished command through the commands that delayed every start (predecessor or command freeing a slot)
+static void micReportCriticalPath(const micCommandGraph *graph, int logLevel)
+{
+    int *path = (int *)MIC_CALLOC(graph->count, sizeof(int));
+    if (path == NULL) return;
+
+    // Commands with predecessors marked first, predicted path starts from a command without them
+    for (int i = 0; i < graph->count; i++)
+    {
+        const micGraphNode *node = &graph->nodes[i];
+        for (int j = 0; j < node->successorCount; j++) path[graph->successors[node->firstSuccessor + j]] = 1;
+    }
+
+    int first = -1;
+    int last = -1;
+
+    for (int i = 0; i < graph->count; i++)
+    {
+        const micGraphNode *node = &graph->nodes[i];
+
+        if ((path[i] == 0) && ((first < 0) || (node->priority > graph->nodes[first].priority))) first = i;
+        if (!node->blocked && ((last < 0) || (node->endTime > graph->nodes[last].endTime))) last = i;
+    }
+
+    if ((first < 0) || (last < 0))
+    {
+        MIC_FREE(path);
+        return;
+    }
+
+    int failed = 0;
+    for (int i = 0; i < graph->count; i++) if (graph->nodes[i].result != 0) failed++;
+
+    micTraceLog(logLevel, "Command graph finished: %i commands (%i failed), critical path predicted %.2f ms, actual %.2f ms",
+        graph->count, failed, graph->nodes[first].priority, graph->nodes[last].endTime - graph->startTime);
+
+    for (int index = first; index >= 0;)
+    {
+        const micGraphNode *node = &graph->nodes[index];
+        micTraceLog(logLevel, "[%s] Critical path (predicted): expected %.2f ms", node->command, node->estimate);
+
+        index = -1;
+        for (int j = 0; j < node->successorCount; j++)
+        {
+            int next = graph->successors[node->firstSuccessor + j];
+            if ((index < 0) || (graph->nodes[next].priority > graph->nodes[index].priority)) index = next;
+        }
+    }
+
+    // NOTE: Actual path found backwards, logged from graph start
+    int length = 0;
+    for (int index = last; (index >= 0) && (length < graph->count); index = graph->nodes[index].gate) path[length++] = index;
+
+    for (int i = length - 1; i >= 0; i--)
+    {
+        const micGraphNode *node = &graph->nodes[path[i]];
+        micTraceLog(logLevel, "[%s] Critical path (actual): started at %.2f ms, %.2f ms (expected %.2f ms)",
+            node->command, node->startTime - graph->startTime, node->endTime - node->startTime, node->estimate);
+    }
+
+    MIC_FREE(path);
+}
+
+// Fill file info from stat() data
+static void micFillFileInfo(micFileInfo *info, const struct stat *st)
+{
+    info->available = true;
+    info->mode = (unsigned int)st->st_mode;
+    info->size = (long long)st->st_size;
+    info->inode = (unsigned long long)st->st_ino;
+#if defined(__APPLE__)
+    info->modTime = (long long)st->st_mtimespec.tv_sec*1000000000LL + st->st_mtimespec.tv_nsec;
+#elif defined(_WIN32)
+    info->modTime = (long long)st->st_mtime*1000000000LL;
+#else
+    info->modTime = (long long)st->st_mtim.tv_sec*1000000000LL + st->st_mtim.tv_nsec;
+#endif
+}
+
+// Query one file metadata (job for micRunParallel())
+static void micGetFileInfoJob(void *userData, int index)
+{
+    micFileInfoJobs *jobs = (micFileInfoJobs *)userData;
+    struct stat st = { 0 };
+
+    memset(&jobs->infos[index], 0, sizeof(micFileInfo));
+    if ((jobs->fileNames[index] != NULL) && (stat(jobs->fileNames[index], &st) == 0)) micFillFileInfo(&jobs->infos[index], &st);
+}
+
+#if defined(MIC_IO_URING_AVAILABLE)
+// Open io_uring instance with submission/completion rings mapped, returns false if not supported
+static bool micOpenRing(micRing *ring, unsigned int entries)
+{
+    memset(ring, 0, sizeof(micRing));
+
+    struct io_uring_params params = { 0 };
+    ring->fd = (int)syscall(__NR_io_uring_setup, entries, &params);
+    if (ring->fd < 0) return false;
+
+    // Map submission/completion rings and submission entries array
+    ring->entries = params.sq_entries;
+    ring->sqSize = params.sq_off.array + params.sq_entries*sizeof(unsigned int);
+    ring->cqSize = params.cq_off.cqes + params.cq_entries*sizeof(struct io_uring_cqe);
+    ring->singleMap = (params.features & IORING_FEAT_SINGLE_MMAP);
+    if (ring->singleMap && (ring->cqSize > ring->sqSize)) ring->sqSize = ring->cqSize;
+
+    ring->sqPtr = (unsigned char *)mmap(NULL, ring->sqSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQ_RING);
+    ring->cqPtr = ring->sqPtr;
+    if (!ring->singleMap && (ring->sqPtr != MAP_FAILED)) ring->cqPtr = (unsigned char *)mmap(NULL, ring->cqSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_CQ_RING);
+    ring->sqesSize = params.sq_entries*sizeof(struct io_uring_sqe);
+    ring->sqes = (struct io_uring_sqe *)mmap(NULL, ring->sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQES);
+
+    if ((ring->sqPtr == MAP_FAILED) || (ring->cqPtr == MAP_FAILED) || ((void *)ring->sqes == MAP_FAILED))
+    {
+        micCloseRing(ring);
+        return false;
+    }
+
+    ring->sqTail = (unsigned int *)(ring->sqPtr + params.sq_off.tail);
+    ring->sqMask = *(unsigned int *)(ring->sqPtr + params.sq_off.ring_mask);
+    ring->sqArray = (unsigned int *)(ring->sqPtr + params.sq_off.array);
+    ring->cqHead = (unsigned int *)(ring->cqPtr + params.cq_off.head);
+    ring->cqTail = (unsigned int *)(ring->cqPtr + params.cq_off.tail);
+    ring->cqMask = *(unsigned int *)(ring->cqPtr + params.cq_off.ring_mask);
+    ring->cqes = (struct io_uring_cqe *)(ring->cqPtr + params.cq_off.cqes);
+
+    return true;
+}
+
+// Close io_uring instance and unmap its rings (requests in flight are cancelled)
+static void micCloseRing(micRing *ring)
+{
+    if ((ring->sqes != NULL) && ((void *)ring->sqes != MAP_FAILED)) munmap(ring->sqes, ring->sqesSize);
+    if (!ring->singleMap && (ring->cqPtr != NULL) && (ring->cqPtr != MAP_FAILED) && (ring->sqPtr != MAP_FAILED)) munmap(ring->cqPtr, ring->cqSize);
+    if ((ring->sqPtr != NULL) && (ring->sqPtr != MAP_FAILED)) munmap(ring->sqPtr, ring->sqSize);
+    if (ring->fd >= 0) close(ring->fd);
+
+    memset(ring, 0, sizeof(micRing));
+    ring->fd = -1;
+}
+
+// Get files metadata with io_uring STATX requests, returns -1 if not supported
+// NOTE: Up to IO_URING_ENTRIES requests are kept in flight, results buffers are recycled by slot
+static int micGetFileInfoBatchRing(const char **fileNames, int count, micFileInfo *infos)
+{
+    micRing ring = { 0 };
+    if (!micOpenRing(&ring, IO_URING_ENTRIES)) return -1;
+
+    struct statx *results = (struct statx *)MIC_CALLOC(ring.entries, sizeof(struct statx));
+    int *slotFile = (int *)MIC_CALLOC(ring.entries, sizeof(int));
+    int *freeSlots = (int *)MIC_CALLOC(ring.entries, sizeof(int));
+
+    int available = -1;
+
+    if ((results != NULL) && (slotFile != NULL) && (freeSlots != NULL))
+    {
+        int freeCount = (int)ring.entries;
+        for (int i = 0; i < freeCount; i++) freeSlots[i] = i;
+
+        int next = 0;           // Next file to submit
+        int inFlight = 0;       // Submitted requests not completed
+        bool failed = false;
+        available = 0;
+
+        while (((next < count) || (inFlight > 0)) && !failed)
+        {
+            // Fill submission queue with as many requests as free result slots
+            unsigned int tail = *ring.sqTail;
+            int submit = 0;
+
+            for (; (next < count) && (freeCount > 0); next++)
+            {
+                memset(&infos[next], 0, sizeof(micFileInfo));
+                if (fileNames[next] == NULL) continue;
+
+                int slot = freeSlots[--freeCount];
+                slotFile[slot] = next;
+
+                struct io_uring_sqe *sqe = &ring.sqes[tail & ring.sqMask];
+                memset(sqe, 0, sizeof(struct io_uring_sqe));
+                sqe->opcode = IORING_OP_STATX;
+                sqe->fd = AT_FDCWD;
+                sqe->addr = (unsigned long long)(uintptr_t)fileNames[next];
+                sqe->len = STATX_BASIC_STATS;
+                sqe->off = (unsigned long long)(uintptr_t)&results[slot];
+                sqe->user_data = (unsigned long long)slot;
+                ring.sqArray[tail & ring.sqMask] = tail & ring.sqMask;
+
+                tail++;
+                submit++;
+            }
+
+            __atomic_store_n(ring.sqTail, tail, __ATOMIC_RELEASE);
+            inFlight += submit;
+            if (inFlight == 0) break;
+
+            if (syscall(__NR_io_uring_enter, ring.fd, submit, 1, IORING_ENTER_GETEVENTS, NULL, 0) < 0)
+            {
+                if (errno == EINTR) continue;
+                failed = true;
+                break;
+            }
+
+            // Reap completions
+            unsigned int head = *ring.cqHead;
+            unsigned int cqEnd = __atomic_load_n(ring.cqTail, __ATOMIC_ACQUIRE);
+
+            for (; head != cqEnd; head++)
+            {
+                struct io_uring_cqe *cqe = &ring.cqes[head & ring.cqMask];
+                int slot = (int)cqe->user_data;
+                int index = slotFile[slot];
+
+                if (cqe->res == 0)
+                {
+                    const struct statx *sx = &results[slot];
+
+                    infos[index].available = true;
+                    infos[index].mode = sx->stx_mode;
+                    infos[index].size = (long long)sx->stx_size;
+                    infos[index].modTime = (long long)sx->stx_mtime.tv_sec*1000000000LL + sx->stx_mtime.tv_nsec;
+                    infos[index].inode = (unsigned long long)sx->stx_ino;
+                    available++;
+                }
+                else if (cqe->res == -EINVAL)
+                {
+                    // STATX operation not supported by kernel, query synchronously
+                    micFileInfoJobs jobs = { fileNames, infos };
+                    micGetFileInfoJob(&jobs, index);
+                    if (infos[index].available) available++;
+                }
+
+                freeSlots[freeCount++] = slot;
+                inFlight--;
+            }
+
+            __atomic_store_n(ring.cqHead, head, __ATOMIC_RELEASE);
+        }
+
+        // NOTE: If ring failed with requests in flight, results buffers could still be written
+        // by the kernel, closing the ring cancels them but buffers are leaked to be safe
+        if (failed)
+        {
+            if (inFlight > 0) results = NULL;
+            available = -1;
+        }
+    }
+
+    micCloseRing(&ring);
+
+    MIC_FREE(results);
+    MIC_FREE(slotFile);
+    MIC_FREE(freeSlots);
+
+    return available;
+}
+#endif
+
+#if !defined(_WIN32)
+// Get directory part of a path into dirPath ("." if none)
+static void micGetParentDirectory(const char *filePath, char *dirPath)
+{
+    const char *lastSlash = strrchr(filePath, '/');
+
+    if (lastSlash == NULL) strcpy(dirPath, ".");
+    else if (lastSlash == filePath) strcpy(dirPath, "/");
+    else
+    {
+        size_t length = lastSlash - filePath;
+        if (length > (MAX_FILEPATH_LENGTH - 1)) length = MAX_FILEPATH_LENGTH - 1;
+
+        memcpy(dirPath, filePath, length);
+        dirPath[length] = '\0';
+    }
+}
+
+// Write all data to a file descriptor, retrying partial writes
+static bool micWriteFileDescriptor(int fd, const void *data, size_t size)
+{
+    const unsigned char *ptr = (const unsigned char *)data;
+
+    while (size > 0)
+    {
+        ssize_t written = write(fd, ptr, size);
+
+        if (written < 0)
+        {
+            if (errno == EINTR) continue;
+            return false;
+        }
+
+        ptr += written;
+        size -= written;
+    }
+
+    return true;
+}
+
+// Set permissions of a temporary file that replaces fileName: existing file permissions are kept,
+// new files get default permissions (0666 minus process umask), already set if defaultMode is true
+static void micSetSaveFileMode(int fd, const char *fileName, bool defaultMode)
+{
+    struct stat info = { 0 };
+
+    if (stat(fileName, &info) == 0) fchmod(fd, info.st_mode & 07777);
+    else if (!defaultMode)
+    {
+        mode_t mask = 022;
+        bool found = false;
+
+#if defined(__linux__)
+        // NOTE: Umask read from /proc (Linux 4.7+), umask() can only query it by changing it (not thread safe)
+        FILE *file = fopen("/proc/self/status", "rt");
+
+        if (file != NULL)
+        {
+            char line[128] = { 0 };
+            unsigned int value = 0;
+
+            while (!found && (fgets(line, 128, file) != NULL)) found = (sscanf(line, "Umask: %o", &value) == 1);
+            if (found) mask = (mode_t)value;
+            fclose(file);
+        }
+#endif
+        if (!found)
+        {
+            mask = umask(022);
+            umask(mask);
+        }
+
+        fchmod(fd, 0666 & ~mask);
+    }
+}
+
+// Sync a directory, persisting its entries (renames)
+static bool micSyncDirectory(const char *dirPath)
+{
+    int fd = open(dirPath, O_RDONLY);
+    if (fd < 0) return false;
+
+    bool success = (fsync(fd) == 0);
+    close(fd);
+
+    return success;
+}
+
+// Register a saved file for the next sync barrier, returns true on success
+// NOTE: On failure the file can not be made durable by the barrier, caller must fail its save
+static bool micAddPendingSync(int fd, const char *fileName, const char *dirPath)
+{
+    bool success = true;
+
+#if defined(__linux__)
+    (void)fileName;
+    (void)dirPath;
+
+    // syncfs() flushes the whole filesystem, keep a single file open per filesystem
+    struct stat info = { 0 };
+    if (fstat(fd, &info) != 0) return false;
+
+    pthread_mutex_lock(&micSyncMutex);
+
+    bool pending = false;
+    for (int i = 0; i < MIC.Sync.count; i++) if (MIC.Sync.devices[i] == info.st_dev) pending = true;
+
+    if (!pending)
+    {
+        int syncFd = (MIC.Sync.count < MAX_SYNC_PENDING_TARGETS)? dup(fd) : -1;
+
+        if (syncFd >= 0)
+        {
+            MIC.Sync.fds[MIC.Sync.count] = syncFd;
+            MIC.Sync.devices[MIC.Sync.count] = info.st_dev;
+            MIC.Sync.count++;
+        }
+        else success = (SYNCFS(fd) == 0);     // Too many filesystems pending, sync this one now
+    }
+
+    pthread_mutex_unlock(&micSyncMutex);
+#else
+    (void)fd;
+
+    // No filesystem barrier available, sync file and parent directory at barrier time
+    char *filePath = (char *)MIC_MALLOC(strlen(fileName) + 1);
+    char *path = (char *)MIC_MALLOC(strlen(dirPath) + 1);
+
+    if ((filePath == NULL) || (path == NULL))
+    {
+        MIC_FREE(filePath);
+        MIC_FREE(path);
+        return false;
+    }
+
+    strcpy(filePath, fileName);
+    strcpy(path, dirPath);
+
+    pthread_mutex_lock(&micSyncMutex);
+
+    if (MIC.Sync.count + 2 > MIC.Sync.capacity)
+    {
+        int capacity = (MIC.Sync.capacity == 0)? 64 : MIC.Sync.capacity*2;
+        char **newPaths = (char **)MIC_REALLOC(MIC.Sync.paths, capacity*sizeof(char *));
+
+        if (newPaths != NULL)
+        {
+            MIC.Sync.paths = newPaths;
+            MIC.Sync.capacity = capacity;
+        }
+    }
+
+    if (MIC.Sync.count + 2 > MIC.Sync.capacity)
+    {
+        MIC_FREE(filePath);
+        MIC_FREE(path);
+        success = false;
+    }
+    else if ((MIC.Sync.count > 0) && (strcmp(MIC.Sync.paths[MIC.Sync.count - 1], dirPath) == 0))
+    {
+        // Same directory as previous file: keep directory entry last, insert file before it
+        MIC.Sync.paths[MIC.Sync.count] = MIC.Sync.paths[MIC.Sync.count - 1];
+        MIC.Sync.paths[MIC.Sync.count - 1] = filePath;
+        MIC.Sync.count++;
+        MIC_FREE(path);
+    }
+    else
+    {
+        MIC.Sync.paths[MIC.Sync.count++] = filePath;
+        MIC.Sync.paths[MIC.Sync.count++] = path;
+    }
+
+    pthread_mutex_unlock(&micSyncMutex);
+#endif
+
+    return success;
+}
+#endif
+
+// Open temporary file to save fileName atomically, returns true on success
+// NOTE: Anonymous file (O_TMPFILE) when available, no leftovers in case of crash before it gets a name,
+// named temporary files are created exclusively (mkstemp()), replaced file permissions are kept
+static bool micOpenSaveTarget(micSaveTarget *target, const char *fileName)
+{
+    target->fileName = fileName;
+    target->tempFileName[0] = '\0';
+
+#if defined(_WIN32)
+    if (snprintf(target->tempFileName, MAX_FILEPATH_LENGTH, "%s.mic%u", fileName, MIC_FETCH_INCREMENT(MIC.Sync.tempCounter)) >= MAX_FILEPATH_LENGTH) return false;
+
+    target->file = fopen(target->tempFileName, "wb");
+
+    return (target->file != NULL);
+#else
+    micGetParentDirectory(fileName, target->dirPath);
+
+    target->fd = -1;
+
+#if defined(O_TMPFILE)
+    target->fd = open(target->dirPath, O_TMPFILE | O_WRONLY | O_CLOEXEC, 0666);
+#endif
+    target->anonymous = (target->fd >= 0);
+
+    if (!target->anonymous)
+    {
+        // Fallback: filesystem does not support O_TMPFILE (or not Linux), use a named temporary file
+        if (snprintf(target->tempFileName, MAX_FILEPATH_LENGTH, "%s.XXXXXX", fileName) < MAX_FILEPATH_LENGTH) target->fd = mkstemp(target->tempFileName);
+        if (target->fd < 0) return false;
+    }
+
+    // NOTE: Replaced file keeps its permissions, mkstemp() files are created 0600
+    micSetSaveFileMode(target->fd, fileName, target->anonymous);
+
+    return true;
+#endif
+}
+
+// Write data to temporary file, returns true on success
+static bool micWriteSaveTarget(micSaveTarget *target, const void *data, size_t size)
+{
+#if defined(_WIN32)
+    return (fwrite(data, 1, size, target->file) == size);
+#else
+    return micWriteFileDescriptor(target->fd, data, size);
+#endif
+}
+
+// Close temporary file: synced (micSetFileSyncMode()) and renamed over target file on success, removed otherwise
+static bool micCloseSaveTarget(micSaveTarget *target, bool success)
+{
+#if defined(_WIN32)
+    success = (fflush(target->file) == 0) && success;
+
+    // NOTE: No filesystem-wide barrier available, batched mode syncs every file
+    if (success && (CTX.syncMode != MIC_FILE_SYNC_NONE)) success = (_commit(_fileno(target->file)) == 0);
+    success = (fclose(target->file) == 0) && success;
+
+    if (success) success = (MoveFileExA(target->tempFileName, target->fileName, 0x1 | 0x8) != 0);  // MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH
+    if (!success) remove(target->tempFileName);
+#else
+    if (success && (CTX.syncMode == MIC_FILE_SYNC_IMMEDIATE)) success = (FDATASYNC(target->fd) == 0);
+
+#if defined(O_TMPFILE)
+    if (success && target->anonymous)
+    {
+        // Give the anonymous file a unique temporary name next to the target
+        // NOTE: linkat() can not replace an existing file, final step is always rename()
+        char procPath[64] = { 0 };
+        snprintf(procPath, 64, "/proc/self/fd/%i", target->fd);
+        success = false;
+
+        for (int i = 0; i < 8; i++)
+        {
+            if (snprintf(target->tempFileName, MAX_FILEPATH_LENGTH, "%s.mic%i.%u", target->fileName, (int)getpid(), MIC_FETCH_INCREMENT(MIC.Sync.tempCounter)) >= MAX_FILEPATH_LENGTH) break;
+            if (linkat(AT_FDCWD, procPath, AT_FDCWD, target->tempFileName, AT_SYMLINK_FOLLOW) == 0) { success = true; break; }
+            if (errno != EEXIST) break;
+        }
+
+        if (!success) target->tempFileName[0] = '\0';
+    }
+#endif
+
+    if (success) success = (rename(target->tempFileName, target->fileName) == 0);
+    if (!success && (target->tempFileName[0] != '\0')) unlink(target->tempFileName);
+
+    if (success)
+    {
+        if (CTX.syncMode == MIC_FILE_SYNC_IMMEDIATE) success = micSyncDirectory(target->dirPath);
+        else if (CTX.syncMode == MIC_FILE_SYNC_BATCHED) success = micAddPendingSync(target->fd, target->fileName, target->dirPath);
+    }
+
+    close(target->fd);
+#endif
+
+    return success;
+}
+
+// Hashing: XXH3 64-bit and BLAKE3 (reference algorithms, seed/key not supported)
+//----------------------------------------------------------------------------------
+static const unsigned char micXxh3Secret[192] = {
+    0xb8, 0xfe, 0x6c, 0x39, 0x23, 0xa4, 0x4b, 0xbe, 0x7c, 0x01, 0x81, 0x2c, 0xf7, 0x21, 0xad, 0x1c,
+    0xde, 0xd4, 0x6d, 0xe9, 0x83, 0x90, 0x97, 0xdb, 0x72, 0x40, 0xa4, 0xa4, 0xb7, 0xb3, 0x67, 0x1f,
+    0xcb, 0x79, 0xe6, 0x4e, 0xcc, 0xc0, 0xe5, 0x78, 0x82, 0x5a, 0xd0, 0x7d, 0xcc, 0xff, 0x72, 0x21,
+    0xb8, 0x08, 0x46, 0x74, 0xf7, 0x43, 0x24, 0x8e, 0xe0, 0x35, 0x90, 0xe6, 0x81, 0x3a, 0x26, 0x4c,
+    0x3c, 0x28, 0x52, 0xbb, 0x91, 0xc3, 0x00, 0xcb, 0x88, 0xd0, 0x65, 0x8b, 0x1b, 0x53, 0x2e, 0xa3,
+    0x71, 0x64, 0x48, 0x97, 0xa2, 0x0d, 0xf9, 0x4e, 0x38, 0x19, 0xef, 0x46, 0xa9, 0xde, 0xac, 0xd8,
+    0xa8, 0xfa, 0x76, 0x3f, 0xe3, 0x9c, 0x34, 0x3f, 0xf9, 0xdc, 0xbb, 0xc7, 0xc7, 0x0b, 0x4f, 0x1d,
+    0x8a, 0x51, 0xe0, 0x4b, 0xcd, 0xb4, 0x59, 0x31, 0xc8, 0x9f, 0x7e, 0xc9, 0xd9, 0x78, 0x73, 0x64,
+    0xea, 0xc5, 0xac, 0x83, 0x34, 0xd3, 0xeb, 0xc3, 0xc5, 0x81, 0xa0, 0xff, 0xfa, 0x13, 0x63, 0xeb,
+    0x17, 0x0d, 0xdd, 0x51, 0xb7, 0xf0, 0xda, 0x49, 0xd3, 0x16, 0x55, 0x26, 0x29, 0xd4, 0x68, 0x9e,
+    0x2b, 0x16, 0xbe, 0x58, 0x7d, 0x47, 0xa1, 0xfc, 0x8f, 0xf8, 0xb8, 0xd1, 0x7a, 0xd0, 0x31, 0xce,
+    0x45, 0xcb, 0x3a, 0x8f, 0x95, 0x16, 0x04, 0x28, 0xaf, 0xd7, 0xfb, 0xca, 0xbb, 0x4b, 0x40, 0x7e,
+};
+
+#define XXH_PRIME32_1   0x9E3779B1U
+#define XXH_PRIME32_2   0x85EBCA77U
+#define XXH_PRIME32_3   0xC2B2AE3DU
+#define XXH_PRIME64_1   0x9E3779B185EBCA87ULL
+#define XXH_PRIME64_2   0xC2B2AE3D27D4EB4FULL
+#define XXH_PRIME64_3   0x165667B19E3779F9ULL
+#define XXH_PRIME64_4   0x85EBCA77C2B2AE63ULL
+#define XXH_PRIME64_5   0x27D4EB2F165667C5ULL
+#define XXH_PRIME_MX1   0x165667919E3779F9ULL
+#define XXH_PRIME_MX2   0x9FB21C651E98DF25ULL
+
+// Read little-endian values from unaligned memory
+static inline uint32_t micReadLE32(const unsigned char *ptr)
+{
+    return (uint32_t)ptr[0] | ((uint32_t)ptr[1] << 8) | ((uint32_t)ptr[2] << 16) | ((uint32_t)ptr[3] << 24);
+}
+
+static inline uint64_t micReadLE64(const unsigned char *ptr)
+{
+    return (uint64_t)micReadLE32(ptr) | ((uint64_t)micReadLE32(ptr + 4) << 32);
+}
+
+static inline uint64_t micRotl64(uint64_t value, int bits) { return (value << bits) | (value >> (64 - bits)); }
+
+static inline uint64_t micSwap64(uint64_t value)
+{
+    value = ((value & 0x00000000ffffffffULL) << 32) | (value >> 32);
+    value = ((value & 0x0000ffff0000ffffULL) << 16) | ((value >> 16) & 0x0000ffff0000ffffULL);
+    return ((value & 0x00ff00ff00ff00ffULL) << 8) | ((value >> 8) & 0x00ff00ff00ff00ffULL);
+}
+
+// Multiply 64x64 -> 128 bits and fold (xor) high and low halves
+static inline uint64_t micMul128Fold64(uint64_t lhs, uint64_t rhs)
+{
+#if defined(__SIZEOF_INT128__)
+    __uint128_t product = (__uint128_t)lhs*rhs;
+    return (uint64_t)product ^ (uint64_t)(product >> 64);
+#else
+    uint64_t loLo = (lhs & 0xffffffff)*(rhs & 0xffffffff);
+    uint64_t hiLo = (lhs >> 32)*(rhs & 0xffffffff);
+    uint64_t loHi = (lhs & 0xffffffff)*(rhs >> 32);
+    uint64_t hiHi = (lhs >> 32)*(rhs >> 32);
+    uint64_t cross = (loLo >> 32) + (hiLo & 0xffffffff) + loHi;
+    uint64_t upper = (hiLo >> 32) + (cross >> 32) + hiHi;
+    uint64_t lower = (cross << 32) | (loLo & 0xffffffff);
+    return lower ^ upper;
+#endif
+}
+
+static inline uint64_t micXxh64Avalanche(uint64_t hash)
+{
+    hash ^= hash >> 33;
+    hash *= XXH_PRIME64_2;
+    hash ^= hash >> 29;
+    hash *= XXH_PRIME64_3;
+    return hash ^ (hash >> 32);
+}
+
+static inline uint64_t micXxh3Avalanche(uint64_t hash)
+{
+    hash ^= hash >> 37;
+    hash *= XXH_PRIME_MX1;
+    return hash ^ (hash >> 32);
+}
+
+static inline uint64_t micXxh3Mix16(const unsigned char *input, const unsigned char *secret)
+{
+    return micMul128Fold64(micReadLE64(input) ^ micReadLE64(secret), micReadLE64(input + 8) ^ micReadLE64(secret + 8));
+}
+
+// Accumulate stripes of 64 bytes into 8 lanes accumulators
+// NOTE: SIMD versions (SSE2/AVX2) compute exactly the same lanes as the scalar one
+static void micXxh3Accumulate(uint64_t *acc, const unsigned char *input, const unsigned char *secret, size_t stripes)
+{
+#if defined(__AVX2__)
+    __m256i accVec[2] = { _mm256_loadu_si256((const __m256i *)acc), _mm256_loadu_si256((const __m256i *)(acc + 4)) };
+
+    for (size_t n = 0; n < stripes; n++)
+    {
+        for (int i = 0; i < 2; i++)
+        {
+            __m256i data = _mm256_loadu_si256((const __m256i *)(input + n*64 + i*32));
+            __m256i key = _mm256_loadu_si256((const __m256i *)(secret + n*8 + i*32));
+            __m256i dataKey = _mm256_xor_si256(data, key);
+            __m256i product = _mm256_mul_epu32(dataKey, _mm256_shuffle_epi32(dataKey, _MM_SHUFFLE(0, 3, 0, 1)));
+            __m256i swapped = _mm256_shuffle_epi32(data, _MM_SHUFFLE(1, 0, 3, 2));
+            accVec[i] = _mm256_add_epi64(accVec[i], _mm256_add_epi64(product, swapped));
+        }
+    }
+
+    _mm256_storeu_si256((__m256i *)acc, accVec[0]);
+    _mm256_storeu_si256((__m256i *)(acc + 4), accVec[1]);
+#elif defined(__SSE2__)
+    __m128i accVec[4] = { 0 };
+    for (int i = 0; i < 4; i++) accVec[i] = _mm_loadu_si128((const __m128i *)(acc + i*2));
+
+    for (size_t n = 0; n < stripes; n++)
+    {
+        for (int i = 0; i < 4; i++)
+        {
+            __m128i data = _mm_loadu_si128((const __m128i *)(input + n*64 + i*16));
+            __m128i key = _mm_loadu_si128((const __m128i *)(secret + n*8 + i*16));
+            __m128i dataKey = _mm_xor_si128(data, key);
+            __m128i product = _mm_mul_epu32(dataKey, _mm_shuffle_epi32(dataKey, _MM_SHUFFLE(0, 3, 0, 1)));
+            __m128i swapped = _mm_shuffle_epi32(data, _MM_SHUFFLE(1, 0, 3, 2));
+            accVec[i] = _mm_add_epi64(accVec[i], _mm_add_epi64(product, swapped));
+        }
+    }
+
+    for (int i = 0; i < 4; i++) _mm_storeu_si128((__m128i *)(acc + i*2), accVec[i]);
+#else
+    for (size_t n = 0; n < stripes; n++)
+    {
+        for (int i = 0; i < 8; i++)
+        {
+            uint64_t data = micReadLE64(input + n*64 + i*8);
+            uint64_t dataKey = data ^ micReadLE64(secret + n*8 + i*8);
+            acc[i ^ 1] += data;
+            acc[i] += (dataKey & 0xffffffff)*(dataKey >> 32);
+        }
+    }
+#endif
+}
+
+// Compute XXH3 64-bit hash (seed 0, default secret)
+static uint64_t micHashXxh3(const unsigned char *input, size_t length)
+{
+    const unsigned char *secret = micXxh3Secret;
+
+    if (length <= 16)
+    {
+        if (length > 8)
+        {
+            uint64_t low = micReadLE64(input) ^ (micReadLE64(secret + 24) ^ micReadLE64(secret + 32));
+            uint64_t high = micReadLE64(input + length - 8) ^ (micReadLE64(secret + 40) ^ micReadLE64(secret + 48));
+            uint64_t acc = length + micSwap64(low) + high + micMul128Fold64(low, high);
+            return micXxh3Avalanche(acc);
+        }
+        else if (length >= 4)
+        {
+            uint64_t input64 = micReadLE32(input + length - 4) + ((uint64_t)micReadLE32(input) << 32);
+            uint64_t hash = input64 ^ (micReadLE64(secret + 8) ^ micReadLE64(secret + 16));
+            hash ^= micRotl64(hash, 49) ^ micRotl64(hash, 24);
+            hash *= XXH_PRIME_MX2;
+            hash ^= (hash >> 35) + length;
+            hash *= XXH_PRIME_MX2;
+            return hash ^ (hash >> 28);
+        }
+        else if (length > 0)
+        {
+            uint32_t combined = ((uint32_t)input[0] << 16) | ((uint32_t)input[length >> 1] << 24) | (uint32_t)input[length - 1] | ((uint32_t)length << 8);
+            uint64_t keyed = (uint64_t)combined ^ (uint64_t)(micReadLE32(secret) ^ micReadLE32(secret + 4));
+            return micXxh64Avalanche(keyed);
+        }
+        else return micXxh64Avalanche(micReadLE64(secret + 56) ^ micReadLE64(secret + 64));
+    }
+    else if (length <= 128)
+    {
+        uint64_t acc = length*XXH_PRIME64_1;
+
+        if (length > 32)
+        {
+            if (length > 64)
+            {
+                if (length > 96)
+                {
+                    acc += micXxh3Mix16(input + 48, secret + 96);
+                    acc += micXxh3Mix16(input + length - 64, secret + 112);
+                }
+                acc += micXxh3Mix16(input + 32, secret + 64);
+                acc += micXxh3Mix16(input + length - 48, secret + 80);
+            }
+            acc += micXxh3Mix16(input + 16, secret + 32);
+            acc += micXxh3Mix16(input + length - 32, secret + 48);
+        }
+        acc += micXxh3Mix16(input, secret);
+        acc += micXxh3Mix16(input + length - 16, secret + 16);
+
+        return micXxh3Avalanche(acc);
+    }
+    else if (length <= 240)
+    {
+        uint64_t acc = length*XXH_PRIME64_1;
+        int rounds = (int)length/16;
+
+        for (int i = 0; i < 8; i++) acc += micXxh3Mix16(input + 16*i, secret + 16*i);
+        acc = micXxh3Avalanche(acc);
+
+        for (int i = 8; i < rounds; i++) acc += micXxh3Mix16(input + 16*i, secret + 16*(i - 8) + 3);
+        acc += micXxh3Mix16(input + length - 16, secret + 136 - 17);
+
+        return micXxh3Avalanche(acc);
+    }
+
+    // Long input: blocks of 16 stripes (64 bytes each), accumulators scrambled after every block
+    uint64_t acc[8] = { XXH_PRIME32_3, XXH_PRIME64_1, XXH_PRIME64_2, XXH_PRIME64_3, XXH_PRIME64_4, XXH_PRIME32_2, XXH_PRIME64_5, XXH_PRIME32_1 };
+    const size_t stripesPerBlock = (192 - 64)/8;
+    const size_t blockLength = 64*stripesPerBlock;
+    size_t blocks = (length - 1)/blockLength;
+
+    for (size_t n = 0; n < blocks; n++)
+    {
+        micXxh3Accumulate(acc, input + n*blockLength, secret, stripesPerBlock);
+
+        for (int i = 0; i < 8; i++)
+        {
+            uint64_t value = acc[i];
+            value ^= value >> 47;
+            value ^= micReadLE64(secret + 192 - 64 + i*8);
+            acc[i] = value*XXH_PRIME32_1;
+        }
+    }
+
+    size_t stripes = ((length - 1) - blockLength*blocks)/64;
+    micXxh3Accumulate(acc, input + blocks*blockLength, secret, stripes);
+    micXxh3Accumulate(acc, input + length - 64, secret + 192 - 64 - 7, 1);
+
+    uint64_t result = length*XXH_PRIME64_1;
+    for (int i = 0; i < 4; i++) result += micMul128Fold64(acc[2*i] ^ micReadLE64(secret + 11 + 16*i), acc[2*i + 1] ^ micReadLE64(secret + 11 + 16*i + 8));
+
+    return micXxh3Avalanche(result);
+}
+
+static const uint32_t micBlake3IV[8] = { 0x6A09E667, 0xBB67AE85, 0x3C6EF372, 0xA54FF53A, 0x510E527F, 0x9B05688C, 0x1F83D9AB, 0x5BE0CD19 };
+
+#define BLAKE3_CHUNK_START      1
+#define BLAKE3_CHUNK_END        2
+#define BLAKE3_PARENT           4
+#define BLAKE3_ROOT             8
+
+static inline uint32_t micRotr32(uint32_t value, int bits) { return (value >> bits) | (value << (32 - bits)); }
+
+#define BLAKE3_G(a, b, c, d, x, y) \
+    state[a] = state[a] + state[b] + (x); state[d] = micRotr32(state[d] ^ state[a], 16); \
+    state[c] = state[c] + state[d]; state[b] = micRotr32(state[b] ^ state[c], 12); \
+    state[a] = state[a] + state[b] + (y); state[d] = micRotr32(state[d] ^ state[a], 8); \
+    state[c] = state[c] + state[d]; state[b] = micRotr32(state[b] ^ state[c], 7);
+
+// BLAKE3 compression function, out gets the new chaining value
+static void micBlake3Compress(const uint32_t cv[8], const unsigned char block[64], uint32_t blockLength, uint64_t counter, uint32_t flags, uint32_t out[8])
+{
+    static const unsigned char schedule[7][16] = {
+        { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15 },
+        { 2, 6, 3, 10, 7, 0, 4, 13, 1, 11, 12, 5, 9, 14, 15, 8 },
+        { 3, 4, 10, 12, 13, 2, 7, 14, 6, 5, 9, 0, 11, 15, 8, 1 },
+        { 10, 7, 12, 9, 14, 3, 13, 15, 4, 0, 11, 2, 5, 8, 1, 6 },
+        { 12, 13, 9, 11, 15, 10, 14, 8, 7, 2, 5, 3, 0, 1, 6, 4 },
+        { 9, 14, 11, 5, 8, 12, 15, 1, 13, 3, 0, 10, 2, 6, 4, 7 },
+        { 11, 15, 5, 0, 1, 9, 8, 6, 14, 10, 2, 12, 3, 4, 7, 13 },
+    };
+
+    uint32_t m[16] = { 0 };
+    for (int i = 0; i < 16; i++) m[i] = micReadLE32(block + i*4);
+
+    uint32_t state[16] = {
+        cv[0], cv[1], cv[2], cv[3], cv[4], cv[5], cv[6], cv[7],
+        micBlake3IV[0], micBlake3IV[1], micBlake3IV[2], micBlake3IV[3],
+        (uint32_t)counter, (uint32_t)(counter >> 32), blockLength, flags
+    };
+
+    for (int r = 0; r < 7; r++)
+    {
+        const unsigned char *s = schedule[r];
+
+        BLAKE3_G(0, 4, 8, 12, m[s[0]], m[s[1]]);
+        BLAKE3_G(1, 5, 9, 13, m[s[2]], m[s[3]]);
+        BLAKE3_G(2, 6, 10, 14, m[s[4]], m[s[5]]);
+        BLAKE3_G(3, 7, 11, 15, m[s[6]], m[s[7]]);
+        BLAKE3_G(0, 5, 10, 15, m[s[8]], m[s[9]]);
+        BLAKE3_G(1, 6, 11, 12, m[s[10]], m[s[11]]);
+        BLAKE3_G(2, 7, 8, 13, m[s[12]], m[s[13]]);
+        BLAKE3_G(3, 4, 9, 14, m[s[14]], m[s[15]]);
+    }
+
+    for (int i = 0; i < 8; i++) out[i] = state[i] ^ state[i + 8];
+}
+
+// BLAKE3 chunk (up to 1024 bytes) chaining value
+static void micBlake3Chunk(const unsigned char *input, size_t length, uint64_t counter, bool root, uint32_t out[8])
+{
+    uint32_t cv[8] = { 0 };
+    memcpy(cv, micBlake3IV, sizeof(cv));
+
+    size_t blocks = (length == 0)? 1 : (length + 63)/64;
+
+    for (size_t i = 0; i < blocks; i++)
+    {
+        unsigned char block[64] = { 0 };
+        size_t blockLength = ((length - i*64) < 64)? (length - i*64) : 64;
+        memcpy(block, input + i*64, blockLength);
+
+        uint32_t flags = 0;
+        if (i == 0) flags |= BLAKE3_CHUNK_START;
+        if (i == (blocks - 1)) flags |= BLAKE3_CHUNK_END | (root? BLAKE3_ROOT : 0);
+
+        micBlake3Compress(cv, block, (uint32_t)blockLength, counter, flags, cv);
+    }
+
+    memcpy(out, cv, sizeof(cv));
+}
+
+// BLAKE3 parent node chaining value
+static void micBlake3Parent(const uint32_t left[8], const uint32_t right[8], bool root, uint32_t out[8])
+{
+    unsigned char block[64] = { 0 };
+
+    for (int i = 0; i < 8; i++)
+    {
+        for (int b = 0; b < 4; b++)
+        {
+            block[i*4 + b] = (unsigned char)(left[i] >> (8*b));
+            block[32 + i*4 + b] = (unsigned char)(right[i] >> (8*b));
+        }
+    }
+
+    micBlake3Compress(micBlake3IV, block, 64, 0, BLAKE3_PARENT | (root? BLAKE3_ROOT : 0), out);
+}
+
+// BLAKE3 subtree chaining value, left subtree gets the largest power of 2 chunks count
+static void micBlake3Subtree(const unsigned char *input, size_t length, uint64_t counter, bool root, uint32_t out[8])
+{
+    if (length <= 1024)
+    {
+        micBlake3Chunk(input, length, counter, root, out);
+        return;
+    }
+
+    size_t leftLength = 1024;
+    while ((leftLength*2) < length) leftLength *= 2;
+
+    uint32_t left[8] = { 0 };
+    uint32_t right[8] = { 0 };
+    micBlake3Subtree(input, leftLength, counter, false, left);
+    micBlake3Subtree(input + leftLength, length - leftLength, counter + leftLength/1024, false, right);
+    micBlake3Parent(left, right, root, out);
+}
+
+// BLAKE3 merge of consecutive units chaining values, same shape as the chunks tree
+static void micBlake3MergeUnits(const uint32_t *cvs, int count, bool root, uint32_t out[8])
+{
+    if (count == 1)
+    {
+        memcpy(out, cvs, 8*sizeof(uint32_t));
+        return;
+    }
+
+    int leftCount = 1;
+    while ((leftCount*2) < count) leftCount *= 2;
+
+    uint32_t left[8] = { 0 };
+    uint32_t right[8] = { 0 };
+    micBlake3MergeUnits(cvs, leftCount, false, left);
+    micBlake3MergeUnits(cvs + leftCount*8, count - leftCount, false, right);
+    micBlake3Parent(left, right, root, out);
+}
+
+// Hash one unit of data (job for micRunParallel())
+static void micHashUnitJob(void *userData, int index)
+{
+    micHashUnits *units = (micHashUnits *)userData;
+
+    size_t offset = (size_t)index*units->unitSize;
+    size_t length = ((units->size - offset) < units->unitSize)? (units->size - offset) : units->unitSize;
+
+    micBlake3Subtree(units->data + offset, length, offset/1024, false, units->results + index*8);
+}
+
+// Hash data in memory, big BLAKE3 inputs are split in units hashed on multiple threads (0 threads: default workers)
+// NOTE: BLAKE3 units are subtrees of the standard tree (result does not depend on units size),
+// XXH3 accumulators are scrambled after every block, it can not be split (hashed by calling thread)
+static micHash micHashMemory(const unsigned char *data, size_t size, int type, int threadCount)
+{
+    micHash hash = { 0 };
+
+    if (type != MIC_HASH_BLAKE3)
+    {
+        uint64_t value = micHashXxh3(data, size);
+        for (int i = 0; i < 8; i++) hash.bytes[i] = (unsigned char)(value >> (56 - 8*i));     // Canonical (big-endian)
+        hash.size = 8;
+
+        return hash;
+    }
+
+    // Units size: power of 2 chunks, big enough to keep threads busy, small enough to fit L2 cache
+    int cacheL2 = micGetSystemTopology()->cacheL2;
+    size_t unitSize = 64*1024;
+    while ((unitSize*2) <= (size_t)cacheL2) unitSize *= 2;
+
+    size_t unitCount = (size > 0)? (size + unitSize - 1)/unitSize : 1;
+    uint32_t out[8] = { 0 };
+
+    if (unitCount <= 1) micBlake3Subtree(data, size, 0, true, out);
+    else
+    {
+        micHashUnits units = { data, size, unitSize, type, (uint32_t *)MIC_CALLOC(unitCount*8, sizeof(uint32_t)) };
+        if (units.results == NULL) return hash;
+
+        micRunParallel(micHashUnitJob, &units, (int)unitCount, threadCount);
+        micBlake3MergeUnits(units.results, (int)unitCount, true, out);
+
+        MIC_FREE(units.results);
+    }
+
+    for (int i = 0; i < 32; i++) hash.bytes[i] = (unsigned char)(out[i/4] >> (8*(i%4)));
+    hash.size = 32;
+
+    return hash;
+}
+
+// Hash one file (job for micRunParallel())
+static void micHashFileJob(void *userData, int index)
+{
+    micHashFiles *files = (micHashFiles *)userData;
+
+    int file = files->indices[index];
+
+    files->hashes[file] = micHashFileThreads(files->fileNames[file], files->type, files->threadCount);
+}
+
+// Hash file content mapped in memory (read into memory if mapping not available)
+static micHash micHashFileThreads(const char *fileName, int type, int threadCount)
+{
+    micHash hash = { 0 };
+
+    if (fileName == NULL) return hash;
+
+#if defined(_WIN32)
+    FILE *file = fopen(fileName, "rb");
+    if (file == NULL) return hash;
+
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+
+    unsigned char *data = (unsigned char *)MIC_MALLOC((size > 0)? size : 1);
+    if ((data != NULL) && (fread(data, 1, size, file) == (size_t)size)) hash = micHashMemory(data, size, type, threadCount);
+
+    MIC_FREE(data);
+    fclose(file);
+#else
+    int fd = open(fileName, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return hash;
+
+    struct stat st = { 0 };
+
+    if ((fstat(fd, &st) == 0) && S_ISREG(st.st_mode))
+    {
+        if (st.st_size == 0) hash = micHashMemory(NULL, 0, type, threadCount);
+        else
+        {
+            void *data = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+            if (data != MAP_FAILED)
+            {
+                madvise(data, (size_t)st.st_size, MADV_SEQUENTIAL);
+                madvise(data, (size_t)st.st_size, MADV_WILLNEED);
+                hash = micHashMemory((const unsigned char *)data, (size_t)st.st_size, type, threadCount);
+                munmap(data, (size_t)st.st_size);
+            }
+        }
+    }
+
+    close(fd);
+#endif
+
+    return hash;
+}
+
+// Compression: CRC32, DEFLATE decoding (inflate), zip archives
+//----------------------------------------------------------------------------------
+static unsigned int micCrc32Table[8][256] = { 0 };  // CRC32 tables (slicing-by-8), initialized by micInitCrc32Table()
+#if !defined(_WIN32)
+static pthread_once_t micCrc32TableOnce = PTHREAD_ONCE_INIT;
+#else
+static bool micCrc32TableReady = false;
+#endif
+
+// DEFLATE match lengths and distances: symbols base values and extra bits
+static const short micLengthBase[29] = { 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+static const short micLengthExtra[29] = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+static const short micDistanceBase[30] = { 1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577 };
+static const short micDistanceExtra[30] = { 0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+static const unsigned char micCodeLengthsOrder[19] = { 16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15 };  // Dynamic block code lengths codes order
+
+// Build CRC32 tables (once per process, see micInitCrc32Table())
+static void micBuildCrc32Table(void)
+{
+    for (unsigned int i = 0; i < 256; i++)
+    {
+        unsigned int crc = i;
+        for (int k = 0; k < 8; k++) crc = (crc & 1)? (crc >> 1) ^ 0xedb88320 : (crc >> 1);
+        micCrc32Table[0][i] = crc;
+    }
+
+    for (int t = 1; t < 8; t++)
+    {
+        for (int i = 0; i < 256; i++) micCrc32Table[t][i] = (micCrc32Table[t - 1][i] >> 8) ^ micCrc32Table[0][micCrc32Table[t - 1][i] & 0xff];
+    }
+}
+
+// Initialize CRC32 tables
+// NOTE: Called by every module using micComputeCrc32() (zip, gzip, log segments), before starting its jobs
+static void micInitCrc32Table(void)
+{
+#if !defined(_WIN32)
+    pthread_once(&micCrc32TableOnce, micBuildCrc32Table);
+#else
+    if (!micCrc32TableReady)
+    {
+        micBuildCrc32Table();
+        micCrc32TableReady = true;
+    }
+#endif
+}
+
+// Compute CRC32 (zip/gzip polynomial), crc is the value of previous data (0 to start)
+// NOTE: Requires CRC32 tables initialized, micInitCrc32Table()
+static unsigned int micComputeCrc32(unsigned int crc, const unsigned char *data, size_t size)
+{
+    crc = ~crc;
+
+    // Slicing-by-8: 8 bytes per iteration
+    while (size >= 8)
+    {
+        unsigned int low = micReadLE32(data) ^ crc;
+        unsigned int high = micReadLE32(data + 4);
+
+        crc = micCrc32Table[7][low & 0xff] ^ micCrc32Table[6][(low >> 8) & 0xff] ^ micCrc32Table[5][(low >> 16) & 0xff] ^ micCrc32Table[4][low >> 24] ^
+              micCrc32Table[3][high & 0xff] ^ micCrc32Table[2][(high >> 8) & 0xff] ^ micCrc32Table[1][(high >> 16) & 0xff] ^ micCrc32Table[0][high >> 24];
+
+        data += 8;
+        size -= 8;
+    }
+
+    while (size-- > 0) crc = (crc >> 8) ^ micCrc32Table[0][(crc ^ *data++) & 0xff];
+
+    return ~crc;
+}
+
+// Get bits from inflate input (LSB first), sets error flag if input is exhausted
+static inline unsigned int micInflateBits(micInflateState *state, int count)
+{
+    while (state->bitCount < count)
+    {
+        if (state->srcPosition >= state->srcSize)
+        {
+            state->error = true;
+            return 0;
+        }
+
+        state->bitBuffer |= (uint64_t)state->src[state->srcPosition++] << state->bitCount;
+        state->bitCount += 8;
+    }
+
+    unsigned int value = (unsigned int)(state->bitBuffer & ((1u << count) - 1));
+    state->bitBuffer >>= count;
+    state->bitCount -= count;
+
+    return value;
+}
+
+// Return whole bytes not consumed from bit buffer to inflate input (only the partial byte bits are kept)
+static inline void micInflateUnread(micInflateState *state)
+{
+    state->srcPosition -= state->bitCount >> 3;
+    state->bitCount &= 7;
+    state->bitBuffer &= ((uint64_t)1 << state->bitCount) - 1;
+}
+
+// Get lookup table entry for a literal/length symbol (code lengths symbols decoded as literals) or a distance symbol
+// NOTE: Code length (bits consumed) is not included
+static unsigned int micInflateSymbolEntry(int symbol, bool distance)
+{
+    unsigned int entry = MIC_INFLATE_ENTRY_INVALID;
+
+    if (distance)
+    {
+        if (symbol < 30) entry = (MIC_INFLATE_ENTRY_MATCH << 8) | (micDistanceExtra[symbol] << 12) | ((unsigned int)micDistanceBase[symbol] << 16);
+    }
+    else if (symbol < 256) entry = (MIC_INFLATE_ENTRY_LITERAL << 8) | ((unsigned int)symbol << 16);
+    else if (symbol == 256) entry = (MIC_INFLATE_ENTRY_END << 8);
+    else if (symbol < 286) entry = (MIC_INFLATE_ENTRY_MATCH << 8) | (micLengthExtra[symbol - 257] << 12) | ((unsigned int)micLengthBase[symbol - 257] << 16);
+
+    return entry;
+}
+
+// Build Huffman codes lookup table from code lengths: root table indexed by tableBits input bits, subtables for longer codes
+// NOTE: Incomplete codes are accepted (missing codes fail when decoded), returns false on over-subscribed codes
+static bool micInflateBuildTable(unsigned int *table, int tableBits, int tableSize, const unsigned char *lengths, int count, bool distance)
+{
+    int counts[16] = { 0 };
+    for (int i = 0; i < count; i++) counts[lengths[i]]++;
+    counts[0] = 0;
+
+    int left = 1;
+    for (int len = 1; len < 16; len++)
+    {
+        left <<= 1;
+        left -= counts[len];
+        if (left < 0) return false;
+    }
+
+    // First canonical code of every length
+    unsigned int nextCode[16] = { 0 };
+    for (int len = 1; len < 16; len++) nextCode[len] = (nextCode[len - 1] + counts[len - 1]) << 1;
+
+    unsigned int rootSize = 1u << tableBits;
+    unsigned int codes[288] = { 0 };                            // Symbols codes, bits reversed (LSB first, as read)
+    unsigned char subtableBits[1 << INFLATE_LENGTH_BITS] = { 0 };
+    memset(table, 0, rootSize*sizeof(unsigned int));
+
+    // Short codes filled in root table (every index starting with the code), longest code per subtable found
+    for (int i = 0; i < count; i++)
+    {
+        int len = lengths[i];
+        if (len == 0) continue;
+
+        unsigned int code = nextCode[len]++;
+        unsigned int reversed = 0;
+        for (int bit = 0; bit < len; bit++, code >>= 1) reversed = (reversed << 1) | (code & 1);
+        codes[i] = reversed;
+
+        if (len <= tableBits)
+        {
+            unsigned int entry = micInflateSymbolEntry(i, distance) | len;
+            for (unsigned int index = reversed; index < rootSize; index += (1u << len)) table[index] = entry;
+        }
+        else
+        {
+            unsigned int index = reversed & (rootSize - 1);
+            if ((len - tableBits) > subtableBits[index]) subtableBits[index] = (unsigned char)(len - tableBits);
+        }
+    }
+
+    // Subtables placed after root table, long codes filled in them
+    unsigned int size = rootSize;
+    for (unsigned int index = 0; index < rootSize; index++)
+    {
+        if (subtableBits[index] == 0) continue;
+        if ((size + (1u << subtableBits[index])) > (unsigned int)tableSize) return false;
+
+        table[index] = (MIC_INFLATE_ENTRY_SUBTABLE << 8) | (subtableBits[index] << 12) | (size << 16);
+        memset(table + size, 0, sizeof(unsigned int) << subtableBits[index]);
+        size += 1u << subtableBits[index];
+    }
+
+    for (int i = 0; i < count; i++)
+    {
+        int len = lengths[i];
+        if (len <= tableBits) continue;
+
+        unsigned int pointer = table[codes[i] & (rootSize - 1)];
+        unsigned int *subtable = table + (pointer >> 16);
+        unsigned int subtableSize = 1u << ((pointer >> 12) & 0xf);
+        unsigned int entry = micInflateSymbolEntry(i, distance) | len;
+
+        for (unsigned int index = codes[i] >> tableBits; index < subtableSize; index += (1u << (len - tableBits))) subtable[index] = entry;
+    }
+
+    return true;
+}
+
+// Combine literal/length root table literals with the next literal, when both codes fit in table bits (two bytes per lookup)
+static void micInflatePairLiterals(unsigned int *table)
+{
+    for (unsigned int index = 0; index < (1u << INFLATE_LENGTH_BITS); index++)
+    {
+        unsigned int entry = table[index];
+        if (((entry >> 8) & 0xf) != MIC_INFLATE_ENTRY_LITERAL) continue;
+
+        // NOTE: Next entry could be a pair already, its first literal is used
+        int len = entry & 0xff;
+        unsigned int next = table[index >> len];
+        int nextKind = (next >> 8) & 0xf;
+        int nextLen = (nextKind == MIC_INFLATE_ENTRY_PAIR)? ((next >> 12) & 0xf) : (int)(next & 0xff);
+
+        if (((nextKind == MIC_INFLATE_ENTRY_LITERAL) || (nextKind == MIC_INFLATE_ENTRY_PAIR)) && ((len + nextLen) <= INFLATE_LENGTH_BITS))
+        {
+            table[index] = (MIC_INFLATE_ENTRY_PAIR << 8) | (len << 12) | (entry & 0xff0000) | ((next & 0xff0000) << 8) | (len + nextLen);
+        }
+    }
+}
+
+// Decode one symbol with lookup table (checked, input read byte by byte), returns table entry or 0 on error
+// NOTE: Literal pairs are returned as a single literal
+static unsigned int micInflateDecode(micInflateState *state, const unsigned int *table, int tableBits)
+{
+    while ((state->bitCount < 15) && (state->srcPosition < state->srcSize))
+    {
+        state->bitBuffer |= (uint64_t)state->src[state->srcPosition++] << state->bitCount;
+        state->bitCount += 8;
+    }
+
+    unsigned int entry = table[state->bitBuffer & ((1u << tableBits) - 1)];
+
+    if (((entry >> 8) & 0xf) == MIC_INFLATE_ENTRY_SUBTABLE) entry = table[(entry >> 16) + ((state->bitBuffer >> tableBits) & ((1u << ((entry >> 12) & 0xf)) - 1))];
+    if (((entry >> 8) & 0xf) == MIC_INFLATE_ENTRY_PAIR) entry = (MIC_INFLATE_ENTRY_LITERAL << 8) | (entry & 0xff0000) | ((entry >> 12) & 0xf);
+
+    int len = entry & 0xff;
+
+    if ((((entry >> 8) & 0xf) == MIC_INFLATE_ENTRY_INVALID) || (len > state->bitCount))
+    {
+        state->error = true;
+        return 0;
+    }
+
+    state->bitBuffer >>= len;
+    state->bitCount -= len;
+
+    return entry;
+}
+
+// Get inflate output space for size bytes (growing output if allowed), returns bytes available (up to size)
+static size_t micInflateSpace(micInflateState *state, size_t size)
+{
+    if ((state->dstSize + size) > state->dstCapacity && state->growable)
+    {
+        size_t capacity = (state->dstCapacity > 0)? state->dstCapacity : 1024;
+        while (capacity < (state->dstSize + size)) capacity *= 2;
+
+        unsigned char *dst = (unsigned char *)MIC_REALLOC(state->dst, capacity);
+
+        if (dst != NULL)
+        {
+            state->dst = dst;
+            state->dstCapacity = capacity;
+        }
+    }
+
+    size_t available = state->dstCapacity - state->dstSize;
+
+    return (available < size)? available : size;
+}
+
+// Read dynamic block Huffman codes (code lengths are Huffman coded themselves)
+static bool micInflateDynamicCodes(micInflateState *state)
+{
+    int lengthCount = (int)micInflateBits(state, 5) + 257;
+    int distanceCount = (int)micInflateBits(state, 5) + 1;
+    int codeCount = (int)micInflateBits(state, 4) + 4;
+    if (state->error || (lengthCount > 286) || (distanceCount > 30)) return false;
+
+    // NOTE: Code lengths codes are 7 bits maximum, no subtables
+    unsigned int codeTable[1 << 7] = { 0 };
+    unsigned char lengths[286 + 30] = { 0 };
+    for (int i = 0; i < codeCount; i++) lengths[micCodeLengthsOrder[i]] = (unsigned char)micInflateBits(state, 3);
+    if (state->error || !micInflateBuildTable(codeTable, 7, 1 << 7, lengths, 19, false)) return false;
+
+    for (int i = 0; i < (lengthCount + distanceCount);)
+    {
+        unsigned int entry = micInflateDecode(state, codeTable, 7);
+        if (entry == 0) return false;
+
+        int symbol = (int)(entry >> 16);
+
+        if (symbol < 16) lengths[i++] = (unsigned char)symbol;
+        else
+        {
+            unsigned char value = 0;
+            int repeat = 0;
+
+            if (symbol == 16)
+            {
+                if (i == 0) return false;
+                value = lengths[i - 1];
+                repeat = 3 + (int)micInflateBits(state, 2);
+            }
+            else if (symbol == 17) repeat = 3 + (int)micInflateBits(state, 3);
+            else repeat = 11 + (int)micInflateBits(state, 7);
+
+            if (state->error || ((i + repeat) > (lengthCount + distanceCount))) return false;
+            while (repeat-- > 0) lengths[i++] = value;
+        }
+    }
+
+    if (lengths[256] == 0) return false;    // End of block code required
+    if (!micInflateBuildTable(state->lengthTable, INFLATE_LENGTH_BITS, INFLATE_LENGTH_TABLE_SIZE, lengths, lengthCount, false)) return false;
+    if (!micInflateBuildTable(state->distanceTable, INFLATE_DISTANCE_BITS, INFLATE_DISTANCE_TABLE_SIZE, lengths + lengthCount, distanceCount, true)) return false;
+
+    micInflatePairLiterals(state->lengthTable);
+
+    return true;
+}
+
+// Inflate Huffman compressed block data without input/output checks per symbol, while margins allow it
+// NOTE: 8 input bytes loaded at once (56+ bits, enough for a whole length/distance pair), matches copied
+// by 8 bytes when distance allows it, returns MIC_INFLATE_NEED_OUTPUT when margins are reached (checked decoding follows)
+static int micInflateFast(micInflateState *state)
+{
+    const unsigned char *src = state->src;
+    size_t srcPosition = state->srcPosition;
+    size_t srcLimit = state->srcSize - INFLATE_FAST_INPUT;
+    unsigned char *dst = state->dst + state->dstSize;
+    unsigned char *dstLimit = state->dst + state->dstCapacity - INFLATE_FAST_OUTPUT;
+    const unsigned int *lengthTable = state->lengthTable;
+    const unsigned int *distanceTable = state->distanceTable;
+    uint64_t bitBuffer = state->bitBuffer;
+    int bitCount = state->bitCount;
+    int result = MIC_INFLATE_NEED_OUTPUT;
+
+    while ((srcPosition <= srcLimit) && (dst <= dstLimit))
+    {
+        // Refill: only whole bytes fitting in bit buffer are consumed, bits over bitCount are next input bits (same values on next refill)
+        bitBuffer |= micReadLE64(src + srcPosition) << bitCount;
+        srcPosition += (63 - bitCount) >> 3;
+        bitCount |= 56;
+
+        unsigned int entry = lengthTable[bitBuffer & ((1u << INFLATE_LENGTH_BITS) - 1)];
+        if (((entry >> 8) & 0xf) == MIC_INFLATE_ENTRY_SUBTABLE) entry = lengthTable[(entry >> 16) + ((bitBuffer >> INFLATE_LENGTH_BITS) & ((1u << ((entry >> 12) & 0xf)) - 1))];
+
+        bitBuffer >>= entry & 0xff;
+        bitCount -= entry & 0xff;
+
+        int kind = (entry >> 8) & 0xf;
+
+        if (kind == MIC_INFLATE_ENTRY_LITERAL) *dst++ = (unsigned char)(entry >> 16);
+        else if (kind == MIC_INFLATE_ENTRY_PAIR)
+        {
+            dst[0] = (unsigned char)(entry >> 16);
+            dst[1] = (unsigned char)(entry >> 24);
+            dst += 2;
+        }
+        else if (kind == MIC_INFLATE_ENTRY_MATCH)
+        {
+            int extra = (entry >> 12) & 0xf;
+            size_t length = (entry >> 16) + (size_t)(bitBuffer & ((1u << extra) - 1));
+            bitBuffer >>= extra;
+            bitCount -= extra;
+
+            entry = distanceTable[bitBuffer & ((1u << INFLATE_DISTANCE_BITS) - 1)];
+            if (((entry >> 8) & 0xf) == MIC_INFLATE_ENTRY_SUBTABLE) entry = distanceTable[(entry >> 16) + ((bitBuffer >> INFLATE_DISTANCE_BITS) & ((1u << ((entry >> 12) & 0xf)) - 1))];
+
+            bitBuffer >>= entry & 0xff;
+            bitCount -= entry & 0xff;
+
+            if (((entry >> 8) & 0xf) != MIC_INFLATE_ENTRY_MATCH)
+            {
+                result = MIC_INFLATE_ERROR;
+                break;
+            }
+
+            extra = (entry >> 12) & 0xf;
+            size_t distance = (entry >> 16) + (size_t)(bitBuffer & ((1u << extra) - 1));
+            bitBuffer >>= extra;
+            bitCount -= extra;
+
+            if (distance > (size_t)(dst - state->dst))
+            {
+                result = MIC_INFLATE_ERROR;
+                break;
+            }
+
+            // NOTE: Wide copies can write up to 7 bytes past match end (output margin), overlapping
+            // matches (distance < 8) copied byte by byte, repeated byte filled at once
+            const unsigned char *from = dst - distance;
+            unsigned char *end = dst + length;
+
+            if (distance >= 8)
+            {
+                do
+                {
+                    memcpy(dst, from, 8);
+                    dst += 8;
+                    from += 8;
+                } while (dst < end);
+            }
+            else if (distance == 1) memset(dst, *from, length);
+            else while (dst < end) *dst++ = *from++;
+
+            dst = end;
+        }
+        else
+        {
+            result = (kind == MIC_INFLATE_ENTRY_END)? MIC_INFLATE_DONE : MIC_INFLATE_ERROR;
+            break;
+        }
+    }
+
+    state->srcPosition = srcPosition;
+    state->bitBuffer = bitBuffer & (((uint64_t)1 << bitCount) - 1);
+    state->bitCount = bitCount;
+    state->dstSize = (size_t)(dst - state->dst);
+
+    return result;
+}
+
+// Inflate Huffman compressed block data (fixed or dynamic codes), returns MIC_INFLATE_DONE at end of block
+static int micInflateCodes(micInflateState *state)
+{
+    while (true)
+    {
+        if (state->matchLength > 0)
+        {
+            // Pending match copy (output was full)
+            size_t count = micInflateSpace(state, state->matchLength);
+            if (count == 0) return MIC_INFLATE_NEED_OUTPUT;
+
+            // NOTE: Source and destination can overlap (distance < length), copy byte by byte
+            unsigned char *dst = state->dst + state->dstSize;
+            const unsigned char *src = dst - state->matchDistance;
+            for (size_t i = 0; i < count; i++) dst[i] = src[i];
+
+            state->dstSize += count;
+            state->matchLength -= count;
+            continue;
+        }
+
+        // Fast decoding while enough input and output space are available (output grown in advance if allowed)
+        if (((state->srcSize - state->srcPosition) >= INFLATE_FAST_INPUT) && (micInflateSpace(state, INFLATE_WINDOW_SIZE) >= INFLATE_FAST_OUTPUT))
+        {
+            int result = micInflateFast(state);
+            if (result != MIC_INFLATE_NEED_OUTPUT) return result;
+        }
+
+        if (!state->srcFinal && ((state->srcSize - state->srcPosition) < INFLATE_SYMBOL_INPUT)) return MIC_INFLATE_NEED_INPUT;
+
+        // Input position saved, a literal could not fit in output (end of block always fits)
+        size_t srcPosition = state->srcPosition;
+        uint64_t bitBuffer = state->bitBuffer;
+        int bitCount = state->bitCount;
+
+        unsigned int entry = micInflateDecode(state, state->lengthTable, INFLATE_LENGTH_BITS);
+        if (entry == 0) return MIC_INFLATE_ERROR;
+
+        int kind = (entry >> 8) & 0xf;
+
+        if (kind == MIC_INFLATE_ENTRY_LITERAL)
+        {
+            if (micInflateSpace(state, 1) == 0)
+            {
+                state->srcPosition = srcPosition;
+                state->bitBuffer = bitBuffer;
+                state->bitCount = bitCount;
+                return MIC_INFLATE_NEED_OUTPUT;
+            }
+
+            state->dst[state->dstSize++] = (unsigned char)(entry >> 16);
+        }
+        else if (kind == MIC_INFLATE_ENTRY_END) return MIC_INFLATE_DONE;
+        else
+        {
+            size_t length = (entry >> 16) + micInflateBits(state, (entry >> 12) & 0xf);
+
+            entry = micInflateDecode(state, state->distanceTable, INFLATE_DISTANCE_BITS);
+            if (entry == 0) return MIC_INFLATE_ERROR;
+
+            size_t distance = (entry >> 16) + micInflateBits(state, (entry >> 12) & 0xf);
+            if (state->error || (distance > state->dstSize)) return MIC_INFLATE_ERROR;
+
+            state->matchLength = length;
+            state->matchDistance = distance;
+        }
+    }
+}
+
+// Inflate raw DEFLATE stream blocks, returns enum micInflateResult
+static int micInflateBlocks(micInflateState *state)
+{
+    while (state->mode != MIC_INFLATE_MODE_DONE)
+    {
+        if (state->mode == MIC_INFLATE_MODE_BLOCK)
+        {
+            if (state->lastBlock)
+            {
+                state->mode = MIC_INFLATE_MODE_DONE;
+                break;
+            }
+
+            if (!state->srcFinal && ((state->srcSize - state->srcPosition) < INFLATE_HEADER_INPUT)) return MIC_INFLATE_NEED_INPUT;
+
+            state->lastBlock = (micInflateBits(state, 1) == 1);
+            unsigned int type = micInflateBits(state, 2);
+            if (state->error) return MIC_INFLATE_ERROR;
+
+            if (type == 0)
+            {
+                // Stored block: skip to byte boundary, length and its complement
+                micInflateUnread(state);
+                state->bitBuffer = 0;
+                state->bitCount = 0;
+
+                if ((state->srcPosition + 4) > state->srcSize) return MIC_INFLATE_ERROR;
+                size_t length = state->src[state->srcPosition] | (state->src[state->srcPosition + 1] << 8);
+                size_t complement = state->src[state->srcPosition + 2] | (state->src[state->srcPosition + 3] << 8);
+                state->srcPosition += 4;
+
+                if (length != (~complement & 0xffff)) return MIC_INFLATE_ERROR;
+
+                state->storedLength = length;
+                state->mode = MIC_INFLATE_MODE_STORED;
+            }
+            else if (type == 1)
+            {
+                // Fixed Huffman codes
+                unsigned char lengths[288 + 30] = { 0 };
+                for (int i = 0; i < 144; i++) lengths[i] = 8;
+                for (int i = 144; i < 256; i++) lengths[i] = 9;
+                for (int i = 256; i < 280; i++) lengths[i] = 7;
+                for (int i = 280; i < 288; i++) lengths[i] = 8;
+                for (int i = 288; i < 288 + 30; i++) lengths[i] = 5;
+
+                micInflateBuildTable(state->lengthTable, INFLATE_LENGTH_BITS, INFLATE_LENGTH_TABLE_SIZE, lengths, 288, false);
+                micInflateBuildTable(state->distanceTable, INFLATE_DISTANCE_BITS, INFLATE_DISTANCE_TABLE_SIZE, lengths + 288, 30, true);
+                micInflatePairLiterals(state->lengthTable);
+
+                state->mode = MIC_INFLATE_MODE_CODES;
+            }
+            else if (type == 2)
+            {
+                if (!micInflateDynamicCodes(state)) return MIC_INFLATE_ERROR;
+
+                state->mode = MIC_INFLATE_MODE_CODES;
+            }
+            else return MIC_INFLATE_ERROR;
+        }
+        else if (state->mode == MIC_INFLATE_MODE_STORED)
+        {
+            if (state->storedLength == 0)
+            {
+                state->mode = MIC_INFLATE_MODE_BLOCK;
+                continue;
+            }
+
+            size_t count = state->srcSize - state->srcPosition;
+            if (count > state->storedLength) count = state->storedLength;
+            if (count == 0) return state->srcFinal? MIC_INFLATE_ERROR : MIC_INFLATE_NEED_INPUT;
+
+            count = micInflateSpace(state, count);
+            if (count == 0) return MIC_INFLATE_NEED_OUTPUT;
+
+            memcpy(state->dst + state->dstSize, state->src + state->srcPosition, count);
+            state->dstSize += count;
+            state->srcPosition += count;
+            state->storedLength -= count;
+        }
+        else
+        {
+            int result = micInflateCodes(state);
+            if (result != MIC_INFLATE_DONE) return result;
+
+            state->mode = MIC_INFLATE_MODE_BLOCK;
+        }
+    }
+
+    return MIC_INFLATE_DONE;
+}
+
+// Inflate raw DEFLATE stream (RFC 1951), returns enum micInflateResult
+// NOTE: Decoding can be resumed after MIC_INFLATE_NEED_INPUT (more src data appended, or srcFinal set)
+// and MIC_INFLATE_NEED_OUTPUT (output consumed), keeping at least 32KB of previous output as history
+// Input bytes loaded ahead in bit buffer are returned on exit: srcPosition is the first byte not consumed
+static int micInflate(micInflateState *state)
+{
+    int result = micInflateBlocks(state);
+    micInflateUnread(state);
+
+    return result;
+}
+
+// Compare zip entries order (biggest first), qsort() callback
+static int micCompareZipOrder(const void *a, const void *b)
+{
+    long long sizeA = ((const micZipOrder *)a)->size;
+    long long sizeB = ((const micZipOrder *)b)->size;
+
+    return (sizeA < sizeB) - (sizeA > sizeB);
+}
+
+// Parse zip central directory (zip64 supported) and build entries names index
+static bool micParseZipDirectory(micZipArchive *zip)
+{
+    const unsigned char *data = zip->data;
+    long long size = zip->dataSize;
+
+    // Find end of central directory record (22 bytes + comment up to 64KB)
+    long long end = -1;
+    for (long long pos = size - 22; (pos >= 0) && (pos >= (size - 22 - 65535)); pos--)
+    {
+        if (micReadLE32(data + pos) == 0x06054b50) { end = pos; break; }
+    }
+    if (end < 0) return false;
+
+    long long entryCount = data[end + 10] | (data[end + 11] << 8);
+    long long directorySize = micReadLE32(data + end + 12);
+    long long directoryOffset = micReadLE32(data + end + 16);
+
+    // Zip64 end of central directory locator, just before the record
+    if ((end >= 20) && (micReadLE32(data + end - 20) == 0x07064b50))
+    {
+        long long end64 = (long long)micReadLE64(data + end - 20 + 8);
+
+        if ((end64 >= 0) && ((end64 + 56) <= size) && (micReadLE32(data + end64) == 0x06064b50))
+        {
+            entryCount = (long long)micReadLE64(data + end64 + 32);
+            directorySize = (long long)micReadLE64(data + end64 + 40);
+            directoryOffset = (long long)micReadLE64(data + end64 + 48);
+        }
+    }
+
+    if ((directoryOffset < 0) || (directorySize < 0) || ((directoryOffset + directorySize) > size) || (entryCount > directorySize/46)) return false;
+
+    zip->entries = (micZipEntry *)MIC_CALLOC((entryCount > 0)? entryCount : 1, sizeof(micZipEntry));
+    zip->names = (char *)MIC_MALLOC(directorySize + 1);       // Names total size is always smaller than directory
+    zip->indexSize = 16;
+    while (zip->indexSize < (entryCount*2)) zip->indexSize *= 2;
+    zip->index = (int *)MIC_CALLOC(zip->indexSize, sizeof(int));
+
+    if ((zip->entries == NULL) || (zip->names == NULL) || (zip->index == NULL)) return false;
+
+    const unsigned char *ptr = data + directoryOffset;
+    const unsigned char *directoryEnd = ptr + directorySize;
+    size_t namesSize = 0;
+
+    for (long long i = 0; i < entryCount; i++)
+    {
+        if (((ptr + 46) > directoryEnd) || (micReadLE32(ptr) != 0x02014b50)) return false;
+
+        int nameLength = ptr[28] | (ptr[29] << 8);
+        int extraLength = ptr[30] | (ptr[31] << 8);
+        int commentLength = ptr[32] | (ptr[33] << 8);
+        if ((ptr + 46 + nameLength + extraLength + commentLength) > directoryEnd) return false;
+
+        micZipEntry *entry = &zip->entries[zip->entryCount];
+        entry->flags = ptr[8] | (ptr[9] << 8);
+        entry->method = ptr[10] | (ptr[11] << 8);
+        entry->crc32 = micReadLE32(ptr + 16);
+        entry->compSize = micReadLE32(ptr + 20);
+        entry->size = micReadLE32(ptr + 24);
+        entry->offset = micReadLE32(ptr + 42);
+        entry->mode = ((ptr[5] == 3)? (micReadLE32(ptr + 38) >> 16) : 0);    // Unix permissions, if created on Unix
+
+        // Zip64 extended information: 64-bit values for fields saturated to 0xffffffff
+        const unsigned char *extra = ptr + 46 + nameLength;
+        const unsigned char *extraEnd = extra + extraLength;
+
+        while ((extra + 4) <= extraEnd)
+        {
+            int id = extra[0] | (extra[1] << 8);
+            int length = extra[2] | (extra[3] << 8);
+            const unsigned char *field = extra + 4;
+            if ((field + length) > extraEnd) break;
+
+            if (id == 0x0001)
+            {
+                if ((entry->size == 0xffffffff) && ((field + 8) <= (extra + 4 + length))) { entry->size = (long long)micReadLE64(field); field += 8; }
+                if ((entry->compSize == 0xffffffff) && ((field + 8) <= (extra + 4 + length))) { entry->compSize = (long long)micReadLE64(field); field += 8; }
+                if ((entry->offset == 0xffffffff) && ((field + 8) <= (extra + 4 + length))) { entry->offset = (long long)micReadLE64(field); field += 8; }
+            }
+
+            extra += 4 + length;
+        }
+
+        memcpy(zip->names + namesSize, ptr + 46, nameLength);
+        zip->names[namesSize + nameLength] = '\0';
+        entry->name = (char *)(uintptr_t)namesSize;        // Offset for now, names buffer could be reallocated
+        namesSize += nameLength + 1;
+
+        zip->entryCount++;
+        ptr += 46 + nameLength + extraLength + commentLength;
+    }
+
+    // Names pointers and index (open addressing, linear probing)
+    for (int i = 0; i < zip->entryCount; i++)
+    {
+        zip->entries[i].name = zip->names + (uintptr_t)zip->entries[i].name;
+
+        unsigned int mask = (unsigned int)zip->indexSize - 1;
+        unsigned int slot = (unsigned int)micHashString(zip->entries[i].name) & mask;
+        while (zip->index[slot] != 0) slot = (slot + 1) & mask;
+        zip->index[slot] = i + 1;
+    }
+
+    return true;
+}
+
+// Get zip entry compressed data, pointer into archive data (after local header)
+static const unsigned char *micGetZipEntryCompData(const micZipArchive *zip, const micZipEntry *entry)
+{
+    if ((entry->offset < 0) || ((entry->offset + 30) > zip->dataSize)) return NULL;
+
+    const unsigned char *header = zip->data + entry->offset;
+    if (micReadLE32(header) != 0x04034b50) return NULL;
+
+    long long start = entry->offset + 30 + (header[26] | (header[27] << 8)) + (header[28] | (header[29] << 8));
+    if ((entry->compSize < 0) || ((start + entry->compSize) > zip->dataSize)) return NULL;
+
+    return zip->data + start;
+}
+
+// Read zip entry data into dst (entry->size bytes), CRC32 is verified
+static bool micReadZipEntry(const micZipEntry *entry, const unsigned char *compData, unsigned char *dst)
+{
+    if (entry->flags & 0x1) return false;           // Encrypted entries not supported
+
+    if (entry->method == 0)
+    {
+        if (entry->compSize != entry->size) return false;
+        memcpy(dst, compData, (size_t)entry->size);
+    }
+    else if (entry->method == 8)
+    {
+        micInflateState state = { 0 };
+        state.src = compData;
+        state.srcSize = (size_t)entry->compSize;
+        state.dst = dst;
+        state.srcFinal = true;
+        state.dstCapacity = (size_t)entry->size;
+
+        if ((micInflate(&state) != MIC_INFLATE_DONE) || (state.dstSize != (size_t)entry->size)) return false;
+    }
+    else return false;                              // Compression method not supported
+
+    return (micComputeCrc32(0, dst, (size_t)entry->size) == entry->crc32);
+}
+
+// Create a directory and all its missing parents
+static void micMakeDirectoryTree(const char *dirPath)
+{
+    char path[MAX_FILEPATH_LENGTH] = { 0 };
+    if (snprintf(path, MAX_FILEPATH_LENGTH, "%s", dirPath) >= MAX_FILEPATH_LENGTH) return;
+
+    for (char *ptr = path + 1; *ptr != '\0'; ptr++)
+    {
+        if ((*ptr == '/') || (*ptr == '\\'))
+        {
+            char separator = *ptr;
+            *ptr = '\0';
+#if defined(_WIN32)
+            _mkdir(path);
+#else
+            mkdir(path, S_IRWXU | S_IRWXG | S_IRWXO);
+#endif
+            *ptr = separator;
+        }
+    }
+
+#if defined(_WIN32)
+    _mkdir(path);
+#else
+    mkdir(path, S_IRWXU | S_IRWXG | S_IRWXO);
+#endif
+}
+
+// Check zip entry name is a relative path that stays inside the extraction directory
+static bool micIsZipPathSafe(const char *name)
+{
+    if ((name[0] == '\0') || (name[0] == '/') || (name[0] == '\\') || (strchr(name, ':') != NULL)) return false;
+
+    for (const char *part = name; *part != '\0';)
+    {
+        if ((part[0] == '.') && (part[1] == '.') && ((part[2] == '\0') || (part[2] == '/') || (part[2] == '\\'))) return false;
+
+        const char *separator = strpbrk(part, "/\\");
+        if (separator == NULL) break;
+        part = separator + 1;
+    }
+
+    return true;
+}
+
+// Extract one zip entry (job for micRunParallel())
+static void micUnzipEntryJob(void *userData, int index)
+{
+    micUnzipJobs *jobs = (micUnzipJobs *)userData;
+    int entryIndex = jobs->order[index].index;
+    const micZipEntry *entry = &jobs->zip->entries[entryIndex];
+
+    // Reject absolute paths and parent directory references (zip slip)
+    const char *name = entry->name;
+    if (!micIsZipPathSafe(name))
+    {
+        micTraceLog(MIC_LOG_WARNING, "[%s] Zip entry path not safe, skipped", name);
+        return;
+    }
+
+    char path[MAX_FILEPATH_LENGTH] = { 0 };
+    if (snprintf(path, MAX_FILEPATH_LENGTH, "%s/%s", jobs->dstPath, name) >= MAX_FILEPATH_LENGTH) return;
+
+    size_t length = strlen(path);
+
+    if ((path[length - 1] == '/') || (path[length - 1] == '\\'))
+    {
+        micMakeDirectoryTree(path);
+        jobs->results[entryIndex] = 1;
+        return;
+    }
+
+    // Make sure parent directory exists
+    char *separator = strrchr(path, '/');
+    if (separator != NULL)
+    {
+        *separator = '\0';
+        if (!micIsDirectoryAvailable(path)) micMakeDirectoryTree(path);
+        *separator = '/';
+    }
+
+    const unsigned char *compData = micGetZipEntryCompData(jobs->zip, entry);
+    bool success = false;
+
+    if ((compData != NULL) && (entry->size <= 0xffffffff))
+    {
+        if ((entry->method == 0) && !(entry->flags & 0x1))
+        {
+            // Stored entry: written straight from archive mapping, no intermediate buffer
+            if ((entry->compSize == entry->size) && (micComputeCrc32(0, compData, (size_t)entry->size) == entry->crc32))
+            {
+                success = micSaveFileData(path, (void *)compData, (unsigned int)entry->size);
+            }
+        }
+        else
+        {
+            unsigned char *data = (unsigned char *)MIC_MALLOC((entry->size > 0)? (size_t)entry->size : 1);
+
+            if ((data != NULL) && micReadZipEntry(entry, compData, data)) success = micSaveFileData(path, data, (unsigned int)entry->size);
+
+            MIC_FREE(data);
+        }
+    }
+
+#if !defined(_WIN32)
+    // Keep executable permissions
+    if (success && (entry->mode & 0111)) chmod(path, entry->mode & 0777);
+#endif
+
+    if (!success) micTraceLog(MIC_LOG_WARNING, "[%s] Zip entry could not be extracted", name);
+    jobs->results[entryIndex] = success? 1 : 0;
+}
+
+// Line reading: line ends search, buffer refill and gzip decompression
+//----------------------------------------------------------------------------------
+// Find line end ('\n'), returns NULL if not found
+// NOTE: 32 (AVX2) or 16 (SSE2) bytes compared at once, C library memchr() otherwise
+static const unsigned char *micFindLineEnd(const unsigned char *data, size_t size)
+{
+#if defined(__AVX2__) && defined(__GNUC__)
+    const __m256i newline = _mm256_set1_epi8('\n');
+
+    while (size >= 32)
+    {
+        unsigned int mask = (unsigned int)_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i *)data), newline));
+        if (mask != 0) return data + __builtin_ctz(mask);
+
+        data += 32;
+        size -= 32;
+    }
+#elif defined(__SSE2__) && defined(__GNUC__)
+    const __m128i newline = _mm_set1_epi8('\n');
+
+    while (size >= 16)
+    {
+        unsigned int mask = (unsigned int)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)data), newline));
+        if (mask != 0) return data + __builtin_ctz(mask);
+
+        data += 16;
+        size -= 16;
+    }
+#endif
+
+    return (size > 0)? (const unsigned char *)memchr(data, '\n', size) : NULL;
+}
+
+// Get gzip member header size (RFC 1952), returns 0 if not valid or not complete
+static size_t micGetGzipHeaderSize(const unsigned char *data, size_t size)
+{
+    if ((size < 10) || (data[0] != 0x1f) || (data[1] != 0x8b) || (data[2] != 8)) return 0;
+
+    int flags = data[3];
+    size_t position = 10;
+
+    if (flags & 0x04)       // FEXTRA
+    {
+        if ((position + 2) > size) return 0;
+        position += 2 + (data[position] | (data[position + 1] << 8));
+    }
+    if (flags & 0x08)       // FNAME
+    {
+        while ((position < size) && (data[position] != 0)) position++;
+        position++;
+    }
+    if (flags & 0x10)       // FCOMMENT
+    {
+        while ((position < size) && (data[position] != 0)) position++;
+        position++;
+    }
+    if (flags & 0x02) position += 2;    // FHCRC
+
+    return (position <= size)? position : 0;
+}
+
+// Decompress gzip data into line reader buffer until full or end of file
+static void micReadGzipData(micLineReader *reader)
+{
+    micInflateState *state = &reader->inflate;
+
+    while (!reader->eof && (state->dstSize < state->dstCapacity))
+    {
+        // Compressed data refill, unread data moved to input start
+        if (!state->srcFinal && ((state->srcSize - state->srcPosition) < INFLATE_HEADER_INPUT))
+        {
+            size_t remaining = state->srcSize - state->srcPosition;
+            memmove(reader->input, reader->input + state->srcPosition, remaining);
+
+            size_t request = LINE_READER_INPUT_SIZE - remaining;
+            size_t bytesRead = fread(reader->input + remaining, 1, request, reader->file);
+
+            state->srcSize = remaining + bytesRead;
+            state->srcPosition = 0;
+            state->srcFinal = (bytesRead < request);
+        }
+
+        const unsigned char *src = state->src + state->srcPosition;
+        size_t available = state->srcSize - state->srcPosition;
+
+        if (reader->gzipStage == 0)
+        {
+            // Member header, files can contain multiple members (concatenated)
+            if (available == 0)
+            {
+                reader->eof = true;
+                break;
+            }
+
+            size_t headerSize = micGetGzipHeaderSize(src, available);
+
+            if (headerSize == 0)
+            {
+                if (reader->gzipMembers == 0) micTraceLog(MIC_LOG_WARNING, "[%s] Gzip header not valid", reader->fileName);
+                else micTraceLog(MIC_LOG_WARNING, "[%s] Gzip trailing data ignored", reader->fileName);
+
+                reader->eof = true;
+                break;
+            }
+
+            state->srcPosition += headerSize;
+            state->mode = MIC_INFLATE_MODE_BLOCK;
+            state->lastBlock = false;
+            state->bitBuffer = 0;
+            state->bitCount = 0;
+            state->error = false;
+            reader->crc32 = 0;
+            reader->memberSize = 0;
+            reader->gzipStage = 1;
+        }
+        else if (reader->gzipStage == 1)
+        {
+            size_t start = state->dstSize;
+            int result = micInflate(state);
+
+            reader->crc32 = micComputeCrc32(reader->crc32, state->dst + start, state->dstSize - start);
+            reader->memberSize += (unsigned int)(state->dstSize - start);
+
+            if (result == MIC_INFLATE_DONE) reader->gzipStage = 2;
+            else if (result == MIC_INFLATE_ERROR)
+            {
+                micTraceLog(MIC_LOG_WARNING, "[%s] Gzip compressed data not valid", reader->fileName);
+                reader->eof = true;
+            }
+        }
+        else
+        {
+            // Member trailer: CRC32 and size (modulo 2^32), deflate data ends at byte boundary
+            state->bitBuffer = 0;
+            state->bitCount = 0;
+
+            if (available < 8)
+            {
+                if (state->srcFinal)
+                {
+                    micTraceLog(MIC_LOG_WARNING, "[%s] Gzip data truncated", reader->fileName);
+                    reader->eof = true;
+                }
+                continue;
+            }
+
+            if ((micReadLE32(src) != reader->crc32) || (micReadLE32(src + 4) != reader->memberSize))
+            {
+                micTraceLog(MIC_LOG_WARNING, "[%s] Gzip data not valid (CRC32 or size mismatch)", reader->fileName);
+                reader->eof = true;
+            }
+
+            state->srcPosition += 8;
+            reader->gzipMembers++;
+            reader->gzipStage = 0;
+        }
+    }
+}
+
+// Refill line reader buffer (unread data moved to buffer start), returns bytes added
+// NOTE: Returns 0 if buffer is full (line longer than buffer) or at end of file (eof flag set)
+static size_t micFillLineReader(micLineReader *reader)
+{
+    // Keep current line, and decompression history (gzip)
+    size_t keep = reader->position;
+
+    if (reader->mode == MIC_LINE_READER_GZIP)
+    {
+        size_t history = (reader->bufferSize > INFLATE_WINDOW_SIZE)? (reader->bufferSize - INFLATE_WINDOW_SIZE) : 0;
+        if (history < keep) keep = history;
+    }
+
+    if (keep > 0)
+    {
+        memmove(reader->buffer, reader->buffer + keep, reader->bufferSize - keep);
+        reader->bufferSize -= keep;
+        reader->position -= keep;
+    }
+
+    size_t start = reader->bufferSize;
+
+    if (reader->mode == MIC_LINE_READER_GZIP)
+    {
+        reader->inflate.dstSize = reader->bufferSize;
+        micReadGzipData(reader);
+        reader->bufferSize = reader->inflate.dstSize;
+    }
+    else if (reader->bufferSize < LINE_READER_BUFFER_SIZE)
+    {
+        reader->bufferSize += fread(reader->buffer + reader->bufferSize, 1, LINE_READER_BUFFER_SIZE - reader->bufferSize, reader->file);
+
+        if (reader->bufferSize == start)
+        {
+            if (ferror(reader->file)) micTraceLog(MIC_LOG_WARNING, "[%s] File could not be read", reader->fileName);
+            reader->eof = true;
+        }
+    }
+
+    return reader->bufferSize - start;
+}
+
+// Multi-pattern replacement
+//----------------------------------------------------------------------------------
+// Reserve replacer output space for size more bytes
+static bool micReserveReplacerOutput(micReplacer *replacer, size_t size)
+{
+    if ((replacer->outputSize + size) <= replacer->outputCapacity) return true;
+
+    size_t capacity = (replacer->outputCapacity > 0)? replacer->outputCapacity : 4096;
+    while (capacity < (replacer->outputSize + size)) capacity *= 2;
+
+    char *output = (char *)MIC_REALLOC(replacer->output, capacity);
+    if (output == NULL) return false;
+
+    replacer->output = output;
+    replacer->outputCapacity = capacity;
+
+    return true;
+}
+
+// Append data to replacer output
+static void micAppendReplacerOutput(micReplacer *replacer, const void *data, size_t size)
+{
+    if ((size == 0) || !micReserveReplacerOutput(replacer, size)) return;
+
+    memcpy(replacer->output + replacer->outputSize, data, size);
+    replacer->outputSize += size;
+}
+
+// Run replacer on data, appending result to output, returns data bytes consumed
+// NOTE: If not final, data after consumed bytes could still be part of a match and must be
+// passed again (at the beginning of next data)
+static size_t micRunReplacer(micReplacer *replacer, const unsigned char *data, size_t size, bool final)
+{
+    const int *next = replacer->next;
+    const unsigned char *classes = replacer->classes;
+    const int classCount = replacer->classCount;
+
+    int state = 0;
+    size_t emitted = 0;         // Data before this position already sent to output
+    size_t matchStart = 0;      // Best match found (leftmost, then longest), not sent yet
+    size_t matchEnd = 0;
+    int matchValue = -1;
+
+    for (size_t i = 0;;)
+    {
+        if (i == size)
+        {
+            if (!final || (matchValue < 0)) break;
+        }
+        else
+        {
+            state = next[state*classCount + classes[data[i]]];
+            i++;
+
+            if (replacer->matchLength[state] > 0)
+            {
+                // Longest key ending here, the one starting first of all keys ending here
+                size_t start = i - replacer->matchLength[state];
+
+                if ((matchValue < 0) || (start < matchStart) || ((start == matchStart) && (i > matchEnd)))
+                {
+                    matchStart = start;
+                    matchEnd = i;
+                    matchValue = replacer->matchValue[state];
+                }
+            }
+
+            // Match is final once no key can start at or before it: current state only holds later data
+            if ((matchValue < 0) || ((i - replacer->depth[state]) <= matchStart)) continue;
+        }
+
+        micAppendReplacerOutput(replacer, data + emitted, matchStart - emitted);
+        micAppendReplacerOutput(replacer, replacer->values[matchValue], replacer->valueLengths[matchValue]);
+        emitted = matchEnd;
+
+        // Data after match is scanned again from the start, replaced keys never overlap
+        i = matchEnd;
+        state = 0;
+        matchValue = -1;
+    }
+
+    // Data that could still start a match is kept (not final)
+    size_t consumed = final? size : size - replacer->depth[state];
+    if ((matchValue >= 0) && (matchStart < consumed)) consumed = matchStart;
+    if (consumed < emitted) consumed = emitted;
+
+    micAppendReplacerOutput(replacer, data + emitted, consumed - emitted);
+
+    return consumed;
+}
+
+// Process journal: completed steps and their outputs fingerprints
+//----------------------------------------------------------------------------------
+// Load previous run journal (only if it belongs to current process)
+// NOTE: Journal is text, one record per step, an incomplete record (crash while writing) ends the journal:
+//   mic-journal 1 <process key> <process description>
+//   step <index> <step key> <outputs count> <step description>
+//   file <size> <modification time> <inode> <xxh3> <path>     (for every output)
+//   end <index>
+static void micLoadJournal(void)
+{
+    unsigned int dataSize = 0;
+    unsigned char *data = micLoadFileData(CTX.Journal.fileName, &dataSize);
+    if (data == NULL) return;
+
+    // Lines are '\0' terminated in place while parsing
+    char *text = (char *)MIC_REALLOC(data, dataSize + 1);
+    if (text == NULL) { MIC_FREE(data); return; }
+    text[dataSize] = '\0';
+
+    int stepCapacity = 0;
+    int outputCapacity = 0;
+    int expectedOutputs = 0;
+    micJournalStep step = { 0 };
+
+    for (char *line = text, *lineEnd = NULL; (lineEnd = strchr(line, '\n')) != NULL; line = lineEnd + 1)
+    {
+        *lineEnd = '\0';
+
+        unsigned long long key = 0;
+        int index = 0;
+        int count = 0;
+
+        if (line == text)
+        {
+            if ((sscanf(line, "mic-journal 1 %llx", &key) < 1) || (key != CTX.Journal.processKey)) break;
+            CTX.Journal.headerSize = (size_t)(lineEnd + 1 - text);
+        }
+        else if (sscanf(line, "step %i %llx %i", &index, &key, &count) == 3)
+        {
+            if ((index != CTX.Journal.stepCount) || (count < 0) || (expectedOutputs > 0)) break;
+
+            step.key = key;
+            step.firstOutput = CTX.Journal.outputCount;
+            step.outputCount = 0;
+            expectedOutputs = count;
+        }
+        else if (strncmp(line, "file ", 5) == 0)
+        {
+            micJournalOutput output = { 0 };
+            int offset = 0;
+
+            if ((expectedOutputs == 0) || (sscanf(line, "file %lli %lli %llu %16s %n", &output.size, &output.modTime, &output.inode, output.hash, &offset) < 4) || (offset == 0)) break;
+
+            if (CTX.Journal.outputCount >= outputCapacity)
+            {
+                outputCapacity = (outputCapacity == 0)? 64 : outputCapacity*2;
+                micJournalOutput *outputs = (micJournalOutput *)MIC_REALLOC(CTX.Journal.outputs, outputCapacity*sizeof(micJournalOutput));
+                if (outputs == NULL) break;
+                CTX.Journal.outputs = outputs;
+            }
+
+            output.path = (char *)MIC_MALLOC(strlen(line + offset) + 1);
+            if (output.path == NULL) break;
+            strcpy(output.path, line + offset);
+
+            CTX.Journal.outputs[CTX.Journal.outputCount++] = output;
+            step.outputCount++;
+            expectedOutputs--;
+        }
+        else if ((sscanf(line, "end %i", &index) == 1) && (index == CTX.Journal.stepCount) && (expectedOutputs == 0))
+        {
+            if (CTX.Journal.stepCount >= stepCapacity)
+            {
+                stepCapacity = (stepCapacity == 0)? 64 : stepCapacity*2;
+                micJournalStep *steps = (micJournalStep *)MIC_REALLOC(CTX.Journal.steps, stepCapacity*sizeof(micJournalStep));
+                if (steps == NULL) break;
+                CTX.Journal.steps = steps;
+            }
+
+            step.end = (size_t)(lineEnd + 1 - text);
+            CTX.Journal.steps[CTX.Journal.stepCount++] = step;
+        }
+        else break;
+    }
+
+    MIC_FREE(text);
+}
+
+// Unload journal data and close journal file
+static void micUnloadJournal(void)
+{
+    if (CTX.Journal.file != NULL) fclose(CTX.Journal.file);
+    CTX.Journal.file = NULL;
+
+    for (int i = 0; i < CTX.Journal.outputCount; i++) MIC_FREE(CTX.Journal.outputs[i].path);
+    for (int i = 0; i < CTX.Journal.stepOutputCount; i++) MIC_FREE(CTX.Journal.stepOutputs[i]);
+
+    MIC_FREE(CTX.Journal.outputs);
+    MIC_FREE(CTX.Journal.steps);
+    MIC_FREE(CTX.Journal.stepOutputs);
+
+    bool resume = CTX.Journal.resume;
+    memset(&CTX.Journal, 0, sizeof(CTX.Journal));
+    CTX.Journal.resume = resume;
+}
+
+// Write journal data to storage (file data, and file entry if new)
+static bool micSyncJournal(bool created)
+{
+    if (fflush(CTX.Journal.file) != 0) return false;
+
+#if defined(_WIN32)
+    return (_commit(_fileno(CTX.Journal.file)) == 0);
+#else
+    if (FDATASYNC(fileno(CTX.Journal.file)) != 0) return false;
+
+    if (created)
+    {
+        char dirPath[MAX_FILEPATH_LENGTH] = { 0 };
+        micGetParentDirectory(CTX.Journal.fileName, dirPath);
+        return micSyncDirectory(dirPath);
+    }
+
+    return true;
+#endif
+}
+
+// Start journal file: previous journal is kept up to keepSize (truncated), or a new journal is started
+static void micResetJournal(const char *description, size_t keepSize)
+{
+    if (CTX.Journal.file != NULL) fclose(CTX.Journal.file);
+
+    bool success = false;
+
+    if (keepSize > 0)
+    {
+        // NOTE: Records of completed steps are never rewritten, only the invalid tail is dropped
+        CTX.Journal.file = fopen(CTX.Journal.fileName, "r+b");
+
+        if (CTX.Journal.file != NULL)
+        {
+#if defined(_WIN32)
+            success = (_chsize_s(_fileno(CTX.Journal.file), keepSize) == 0);
+#else
+            success = (ftruncate(fileno(CTX.Journal.file), (off_t)keepSize) == 0);
+#endif
+            if (success) success = (fseek(CTX.Journal.file, 0, SEEK_END) == 0) && micSyncJournal(false);
+        }
+    }
+    else
+    {
+        CTX.Journal.file = fopen(CTX.Journal.fileName, "wb");
+
+        if (CTX.Journal.file != NULL)
+        {
+            if (description == NULL) description = "";
+            fprintf(CTX.Journal.file, "mic-journal 1 %016llx %.*s\n", CTX.Journal.processKey, (int)strcspn(description, "\r\n"), description);
+            success = micSyncJournal(true);
+        }
+    }
+
+    if (!success) micTraceLog(MIC_LOG_WARNING, "[%s] Journal file could not be started, steps will not be recorded", CTX.Journal.fileName);
+    if (!success && (CTX.Journal.file != NULL))
+    {
+        fclose(CTX.Journal.file);
+        CTX.Journal.file = NULL;
+    }
+}
+
+// Check journal step outputs are unchanged: file metadata (cheap) or content hash if metadata changed
+static bool micIsJournalStepValid(const micJournalStep *step)
+{
+    int count = step->outputCount;
+    if (count == 0) return true;
+
+    const micJournalOutput *outputs = &CTX.Journal.outputs[step->firstOutput];
+    const char **paths = (const char **)MIC_CALLOC(count, sizeof(char *));
+    micFileInfo *infos = (micFileInfo *)MIC_CALLOC(count, sizeof(micFileInfo));
+    micHash *hashes = (micHash *)MIC_CALLOC(count, sizeof(micHash));
+    bool valid = (paths != NULL) && (infos != NULL) && (hashes != NULL);
+
+    if (valid)
+    {
+        for (int i = 0; i < count; i++) paths[i] = outputs[i].path;
+        micGetFileInfoBatch(paths, count, infos);
+
+        // Outputs with same size but other modification time or inode (touched, copied) are hashed
+        int hashCount = 0;
+
+        for (int i = 0; valid && (i < count); i++)
+        {
+            if (!infos[i].available || (outputs[i].size < 0) || (infos[i].size != outputs[i].size)) valid = false;
+            else if ((infos[i].modTime != outputs[i].modTime) || (infos[i].inode != outputs[i].inode)) paths[hashCount++] = outputs[i].path;
+        }
+
+        if (valid && (hashCount > 0))
+        {
+            micHashFileList(paths, hashCount, MIC_HASH_XXH3, hashes);
+
+            for (int i = 0, k = 0; valid && (i < count); i++)
+            {
+                if ((infos[i].modTime == outputs[i].modTime) && (infos[i].inode == outputs[i].inode)) continue;
+                if (strcmp(micHashToString(hashes[k++]), outputs[i].hash) != 0) valid = false;
+            }
+        }
+    }
+
+    MIC_FREE(paths);
+    MIC_FREE(infos);
+    MIC_FREE(hashes);
+
+    return valid;
+}
+
+// Append current step record to journal (outputs fingerprints), synced to storage
+static void micAppendJournalStep(void)
+{
+    if (CTX.Journal.file == NULL) return;
+
+    int count = CTX.Journal.stepOutputCount;
+    const char **paths = (const char **)CTX.Journal.stepOutputs;
+    micFileInfo *infos = (micFileInfo *)MIC_CALLOC((count > 0)? count : 1, sizeof(micFileInfo));
+    micHash *hashes = (micHash *)MIC_CALLOC((count > 0)? count : 1, sizeof(micHash));
+
+    size_t size = 256;
+    for (int i = 0; i < count; i++) size += strlen(paths[i]) + 96;
+    char *record = (char *)MIC_MALLOC(size);
+
+    if ((infos != NULL) && (hashes != NULL) && (record != NULL))
+    {
+        if (count > 0)
+        {
+            micGetFileInfoBatch(paths, count, infos);
+            micHashFileList(paths, count, MIC_HASH_XXH3, hashes);
+        }
+
+        // NOTE: Record written at once, a partial record (crash) is discarded on load
+        int length = sprintf(record, "step %i %016llx %i %s\n", CTX.Journal.stepIndex, CTX.Journal.stepKey, count, CTX.Journal.stepDescription);
+
+        for (int i = 0; i < count; i++)
+        {
+            if (!infos[i].available || (hashes[i].size == 0))
+            {
+                micTraceLog(MIC_LOG_WARNING, "[%s] Step output not available, step will not be resumed", paths[i]);
+                infos[i].size = -1;
+            }
+
+            length += sprintf(record + length, "file %lli %lli %llu %s %s\n", infos[i].size, infos[i].modTime, infos[i].inode,
+                              (hashes[i].size > 0)? micHashToString(hashes[i]) : "0000000000000000", paths[i]);
+        }
+
+        length += sprintf(record + length, "end %i\n", CTX.Journal.stepIndex);
+
+        if ((fwrite(record, 1, length, CTX.Journal.file) != (size_t)length) || !micSyncJournal(false))
+        {
+            micTraceLog(MIC_LOG_WARNING, "[%s] Step could not be recorded in journal", CTX.Journal.stepDescription);
+        }
+    }
+
+    MIC_FREE(infos);
+    MIC_FREE(hashes);
+    MIC_FREE(record);
+}
+
+// Event loop: futures completion, commands reaping, io_uring file requests
+//----------------------------------------------------------------------------------
+
+// Initialize event loop (once), returns false if not available (not Linux)
+// NOTE: io_uring completions are notified to an eventfd watched by epoll, so one epoll_wait()
+// waits for children exit, timers expiration and file requests completion
+static bool micInitEventLoop(void)
+{
+#if defined(__linux__)
+    if (!CTX.Loop.ready)
+    {
+        CTX.Loop.ready = true;
+        CTX.Loop.epollFd = epoll_create1(EPOLL_CLOEXEC);
+
+#if defined(MIC_IO_URING_AVAILABLE)
+        CTX.Loop.ring.fd = -1;
+        CTX.Loop.ringEventFd = -1;
+
+        if ((CTX.Loop.epollFd >= 0) && micOpenRing(&CTX.Loop.ring, IO_URING_ENTRIES))
+        {
+            struct epoll_event event = { 0 };
+            event.events = EPOLLIN;
+            event.data.ptr = &CTX.Loop.ring;
+
+            CTX.Loop.ringEventFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+            if ((CTX.Loop.ringEventFd < 0) ||
+                (syscall(__NR_io_uring_register, CTX.Loop.ring.fd, IORING_REGISTER_EVENTFD, &CTX.Loop.ringEventFd, 1) < 0) ||
+                (epoll_ctl(CTX.Loop.epollFd, EPOLL_CTL_ADD, CTX.Loop.ringEventFd, &event) < 0))
+            {
+                if (CTX.Loop.ringEventFd >= 0) close(CTX.Loop.ringEventFd);
+                CTX.Loop.ringEventFd = -1;
+                micCloseRing(&CTX.Loop.ring);
+            }
+        }
+#endif
+        if (CTX.Loop.epollFd < 0) micTraceLog(MIC_LOG_WARNING, "Event loop not available, asynchronous operations run synchronously");
+    }
+
+    return (CTX.Loop.epollFd >= 0);
+#else
+    return false;
+#endif
+}
+
+// Unload event loop: epoll instance and io_uring closed
+// NOTE: No pending futures expected, event loop is initialized again if required
+static void micUnloadEventLoop(void)
+{
+#if defined(__linux__)
+    if (!CTX.Loop.ready) return;
+
+#if defined(MIC_IO_URING_AVAILABLE)
+    if (CTX.Loop.ringEventFd >= 0) close(CTX.Loop.ringEventFd);
+    if (CTX.Loop.ring.fd >= 0) micCloseRing(&CTX.Loop.ring);
+#endif
+    if (CTX.Loop.epollFd >= 0) close(CTX.Loop.epollFd);
+
+    memset(&CTX.Loop, 0, sizeof(CTX.Loop));
+#endif
+}
+
+// Create pending future, added to event loop pending list
+static micFuture *micCreateFuture(int type, const char *name)
+{
+    micFuture *future = (micFuture *)MIC_CALLOC(1, sizeof(micFuture));
+    if (future == NULL) return NULL;
+
+    future->type = type;
+    future->fd = -1;
+    future->startTime = micGetTime();
+
+    if (name != NULL)
+    {
+        future->name = (char *)MIC_MALLOC(strlen(name) + 1);
+
+        if (future->name == NULL)
+        {
+            MIC_FREE(future);
+            return NULL;
+        }
+
+        strcpy(future->name, name);
+    }
+
+    future->next = CTX.Loop.pending;
+    if (CTX.Loop.pending != NULL) CTX.Loop.pending->prev = future;
+    CTX.Loop.pending = future;
+    CTX.Loop.pendingCount++;
+
+    return future;
+}
+
+// Free future data (loaded data not taken is freed too)
+static void micFreeFuture(micFuture *future)
+{
+    if (future->type == MIC_FUTURE_LOAD) MIC_FREE(future->data);
+
+    MIC_FREE(future->tempFileName);
+    MIC_FREE(future->name);
+    MIC_FREE(future);
+}
+
+// Complete future: removed from pending list, continuation called, freed if unloaded
+static void micCompleteFuture(micFuture *future, int result)
+{
+    if (future->prev != NULL) future->prev->next = future->next;
+    else CTX.Loop.pending = future->next;
+    if (future->next != NULL) future->next->prev = future->prev;
+
+    future->prev = NULL;
+    future->next = NULL;
+    future->ready = true;
+    future->result = result;
+
+    CTX.Loop.pendingCount--;
+    CTX.Loop.completedCount++;
+
+    // NOTE: Continuation could unload the future (not detached yet), it can not be accessed after it
+    bool detached = future->detached;
+
+    if (future->callback != NULL) future->callback(future, future->userData);
+    if (detached) micFreeFuture(future);
+}
+
+#if defined(__linux__)
+// Watch future file descriptor (pidfd, timerfd) with event loop epoll, returns true on success
+static bool micWatchFuture(micFuture *future)
+{
+    if (future->fd < 0) return false;
+
+    struct epoll_event event = { 0 };
+    event.events = EPOLLIN;
+    event.data.ptr = future;
+
+    return (epoll_ctl(CTX.Loop.epollFd, EPOLL_CTL_ADD, future->fd, &event) == 0);
+}
+
+// Reap command future child process (if exited), completed with exit code
+static void micReapCommandFuture(micFuture *future)
+{
+    int status = 0;
+    struct rusage usage = { 0 };
+    pid_t pid = -1;
+
+    do pid = wait4((pid_t)future->pid, &status, WNOHANG, &usage);
+    while ((pid < 0) && (errno == EINTR));
+
+    if (pid == 0) return;   // Still running
+
+    int result = -1;
+
+    if (pid > 0)
+    {
+        if (WIFEXITED(status)) result = WEXITSTATUS(status);
+        else if (WIFSIGNALED(status)) result = 128 + WTERMSIG(status);
+
+        long long peakMemory = (long long)usage.ru_maxrss*1024;    // NOTE: Kilobytes on Linux
+        if ((peakMemory > 0) || (result == 0)) micUpdateCommandStats(future->name, peakMemory, (result == 0)? (micGetTime() - future->startTime) : 0);
+
+        micTraceLog(MIC_LOG_DEBUG, "[%s] Command finished: exit code %i, %.2f ms, peak memory %lli KB", future->name, result, micGetTime() - future->startTime, peakMemory/1024);
+    }
+
+    if (result != 0) micTraceLog(MIC_LOG_WARNING, "[%s] Command failed with exit code %i", future->name, result);
+
+    // NOTE: Closing pidfd removes it from epoll
+    if (future->fd >= 0) close(future->fd);
+    else CTX.Loop.polledCount--;
+
+    future->fd = -1;
+
+    micCompleteFuture(future, result);
+}
+
+#if defined(MIC_IO_URING_AVAILABLE)
+// Transfer file future remaining data synchronously (pread/pwrite, fdatasync if required), returns true on success
+// NOTE: Used when io_uring requests can not be submitted or are not supported by kernel
+static bool micTransferFileFuture(micFuture *future)
+{
+    while (future->done < future->size)
+    {
+        size_t size = future->size - future->done;
+        if (size > (1 << 30)) size = (1 << 30);
+
+        ssize_t result = 0;
+        if (future->type == MIC_FUTURE_LOAD) result = pread(future->fd, future->data + future->done, size, (off_t)future->done);
+        else result = pwrite(future->fd, future->data + future->done, size, (off_t)future->done);
+
+        if ((result < 0) && (errno == EINTR)) continue;
+        if (result < 0) return false;
+        if (result == 0)
+        {
+            // NOTE: File shrank while loading, data loaded up to end of file
+            if (future->type != MIC_FUTURE_LOAD) return false;
+            future->size = future->done;
+            break;
+        }
+
+        future->done += (size_t)result;
+    }
+
+    if ((future->type == MIC_FUTURE_SAVE) && (CTX.syncMode == MIC_FILE_SYNC_IMMEDIATE)) return (FDATASYNC(future->fd) == 0);
+
+    return true;
+}
+
+// Finish file future: file closed (saved file renamed over target and synced), completed
+static void micFinishFileFuture(micFuture *future, bool success)
+{
+    if (future->type == MIC_FUTURE_SAVE)
+    {
+        if (success && (future->tempFileName != NULL))
+        {
+            char dirPath[MAX_FILEPATH_LENGTH] = { 0 };
+            micGetParentDirectory(future->name, dirPath);
+
+            success = (rename(future->tempFileName, future->name) == 0);
+
+            if (success)
+            {
+                if (CTX.syncMode == MIC_FILE_SYNC_IMMEDIATE) success = micSyncDirectory(dirPath);
+                else if (CTX.syncMode == MIC_FILE_SYNC_BATCHED) success = micAddPendingSync(future->fd, future->name, dirPath);
+            }
+            else unlink(future->tempFileName);
+        }
+        else if (future->tempFileName != NULL) unlink(future->tempFileName);
+
+        // NOTE: Saved data belongs to the user
+        future->data = NULL;
+        future->size = 0;
+
+        if (success) micTraceLog(MIC_LOG_INFO, "[%s] File saved successfully", future->name);
+        else micTraceLog(MIC_LOG_WARNING, "[%s] File could not be saved", future->name);
+    }
+    else
+    {
+        if (success) micTraceLog(MIC_LOG_INFO, "[%s] File loaded successfully", future->name);
+        else
+        {
+            if (future->data != NULL) micTraceLog(MIC_LOG_WARNING, "[%s] File could not be read", future->name);
+
+            MIC_FREE(future->data);
+            future->data = NULL;
+            future->size = 0;
+        }
+    }
+
+    if (future->fd >= 0) close(future->fd);
+    future->fd = -1;
+
+    micCompleteFuture(future, success? 0 : -1);
+}
+
+// Submit next ring request of a file future: read/write remaining data or fdatasync(), returns false if not submitted
+static bool micSubmitFileFuture(micFuture *future)
+{
+    micRing *ring = &CTX.Loop.ring;
+    if ((ring->fd < 0) || CTX.Loop.ringDisabled || (CTX.Loop.ringInFlight >= (int)ring->entries)) return false;
+
+    unsigned int tail = *ring->sqTail;
+    struct io_uring_sqe *sqe = &ring->sqes[tail & ring->sqMask];
+    memset(sqe, 0, sizeof(struct io_uring_sqe));
+
+    size_t size = future->size - future->done;
+    if (size > (1 << 30)) size = (1 << 30);
+
+    if (future->syncing)
+    {
+        sqe->opcode = IORING_OP_FSYNC;
+        sqe->fsync_flags = IORING_FSYNC_DATASYNC;
+    }
+    else
+    {
+        sqe->opcode = (future->type == MIC_FUTURE_LOAD)? IORING_OP_READ : IORING_OP_WRITE;
+        sqe->addr = (unsigned long long)(uintptr_t)(future->data + future->done);
+        sqe->len = (unsigned int)size;
+        sqe->off = (unsigned long long)future->done;
+    }
+
+    sqe->fd = future->fd;
+    sqe->user_data = (unsigned long long)(uintptr_t)future;
+    ring->sqArray[tail & ring->sqMask] = tail & ring->sqMask;
+
+    __atomic_store_n(ring->sqTail, tail + 1, __ATOMIC_RELEASE);
+
+    long submitted = -1;
+    do submitted = syscall(__NR_io_uring_enter, ring->fd, 1, 0, 0, NULL, 0);
+    while ((submitted < 0) && (errno == EINTR));
+
+    if (submitted != 1)
+    {
+        // NOTE: Request could stay in submission queue, ring is not used anymore for new requests
+        micTraceLog(MIC_LOG_WARNING, "File requests could not be submitted, asynchronous file operations run synchronously");
+        CTX.Loop.ringDisabled = true;
+        return false;
+    }
+
+    CTX.Loop.ringInFlight++;
+
+    return true;
+}
+
+// Process ring completions: file futures advanced to next request or finished
+static void micProcessRingEvents(void)
+{
+    micRing *ring = &CTX.Loop.ring;
+
+    uint64_t notifications = 0;
+    if (read(CTX.Loop.ringEventFd, &notifications, sizeof(uint64_t)) != sizeof(uint64_t)) notifications = 0;   // Reset notifications counter
+
+    unsigned int head = *ring->cqHead;
+
+    while (head != __atomic_load_n(ring->cqTail, __ATOMIC_ACQUIRE))
+    {
+        struct io_uring_cqe *cqe = &ring->cqes[head & ring->cqMask];
+        micFuture *future = (micFuture *)(uintptr_t)cqe->user_data;
+        int result = cqe->res;
+
+        // NOTE: Completion entry released before processing, new requests can be submitted from continuations
+        head++;
+        __atomic_store_n(ring->cqHead, head, __ATOMIC_RELEASE);
+        CTX.Loop.ringInFlight--;
+
+        if ((result == -EINTR) || (result == -EAGAIN))
+        {
+            if (!micSubmitFileFuture(future)) micFinishFileFuture(future, micTransferFileFuture(future));
+            continue;
+        }
+
+        if ((result == -EINVAL) || (result == -EOPNOTSUPP))
+        {
+            // Request not supported by kernel (READ/WRITE require 5.6), continue synchronously
+            micFinishFileFuture(future, micTransferFileFuture(future));
+            continue;
+        }
+
+        if ((result < 0) || ((result == 0) && !future->syncing && (future->type == MIC_FUTURE_SAVE)))
+        {
+            micFinishFileFuture(future, false);
+            continue;
+        }
+
+        if (future->syncing)
+        {
+            micFinishFileFuture(future, true);
+            continue;
+        }
+
+        if (result == 0) future->size = future->done;       // NOTE: File shrank while loading
+        else future->done += (size_t)result;
+
+        if (future->done < future->size)
+        {
+            if (!micSubmitFileFuture(future)) micFinishFileFuture(future, micTransferFileFuture(future));
+        }
+        else if ((future->type == MIC_FUTURE_SAVE) && (CTX.syncMode == MIC_FILE_SYNC_IMMEDIATE))
+        {
+            future->syncing = true;
+            if (!micSubmitFileFuture(future)) micFinishFileFuture(future, (FDATASYNC(future->fd) == 0));
+        }
+        else micFinishFileFuture(future, true);
+    }
+}
+#endif  // MIC_IO_URING_AVAILABLE
+#endif  // __linux__
+
+// Paths interning: normalization, hash table, strings storage
+//----------------------------------------------------------------------------------
+
+// Normalize path in place (lexically), returns normalized length
+// NOTE: Path buffer must hold length + 2 bytes, normalized path is never longer than path (except "" -> ".")
+static size_t micNormalizePath(char *path, size_t length)
+{
+    size_t size = 0;        // Normalized path size (written over path, never ahead of read position)
+    size_t i = 0;
+
+#if defined(_WIN32)
+    // Drive letter kept as root prefix, separators normalized to '/'
+    if ((length >= 2) && (path[1] == ':') && (((path[0] >= 'A') && (path[0] <= 'Z')) || ((path[0] >= 'a') && (path[0] <= 'z')))) size = i = 2;
+#endif
+    if ((i < length) && IS_PATH_SEPARATOR(path[i]))
+    {
+        path[size++] = '/';
+        i++;
+    }
+
+    size_t rootLength = size;
+    bool absolute = (rootLength > 0) && (path[rootLength - 1] == '/');
+
+    while (i < length)
+    {
+        while ((i < length) && IS_PATH_SEPARATOR(path[i])) i++;
+
+        size_t start = i;
+        while ((i < length) && !IS_PATH_SEPARATOR(path[i])) i++;
+
+        size_t count = i - start;
+        if ((count == 0) || ((count == 1) && (path[start] == '.'))) continue;
+
+        if ((count == 2) && (path[start] == '.') && (path[start + 1] == '.'))
+        {
+            // Previous component removed, unless it is ".." too (relative path going up)
+            size_t last = size;
+            while ((last > rootLength) && (path[last - 1] != '/')) last--;
+
+            bool previousUp = ((size - last) == 2) && (path[last] == '.') && (path[last + 1] == '.');
+
+            if ((size > rootLength) && !previousUp)
+            {
+                size = (last > rootLength)? last - 1 : rootLength;
+                continue;
+            }
+
+            if (absolute) continue;     // Nothing above root
+        }
+
+        if (size > rootLength) path[size++] = '/';
+        memmove(path + size, path + start, count);
+        size += count;
+    }
+
+    if (size == 0) path[size++] = '.';
+    path[size] = '\0';
+
+    return size;
+}
+
+// Get interned path entry (NULL if id not valid)
+static micPathEntry *micGetPathEntry(unsigned int pathId)
+{
+    if ((pathId == 0) || (pathId > MIC.Paths.count) || (MIC.Paths.pages == NULL)) return NULL;
+
+    return &MIC.Paths.pages[pathId/PATH_ENTRIES_PAGE_SIZE][pathId%PATH_ENTRIES_PAGE_SIZE];
+}
+
+// Get path id of path data (exact bytes), inserted if not found and insert requested, returns 0 on failure
+// NOTE: Requires micPathsMutex locked, entries and strings never move once inserted
+static unsigned int micInternPathData(const char *path, size_t length, bool insert)
+{
+    if (length >= 0xffffffff) return 0;
+
+    unsigned int hash = (unsigned int)micHashXxh3((const unsigned char *)path, length);
+
+    if (MIC.Paths.table != NULL)
+    {
+        unsigned int mask = MIC.Paths.tableSize - 1;
+
+        for (unsigned int slot = hash & mask; MIC.Paths.table[slot] != 0; slot = (slot + 1) & mask)
+        {
+            const micPathEntry *entry = micGetPathEntry(MIC.Paths.table[slot]);
+            if ((entry->hash == hash) && (entry->length == length) && (memcmp(entry->path, path, length) == 0)) return MIC.Paths.table[slot];
+        }
+    }
+
+    if (!insert || (MIC.Paths.count >= 0xfffffffe)) return 0;
+
+    // Grow hash table (load factor kept under 1/2), entries rehashed from their stored hash
+    if ((MIC.Paths.count + 1)*2 > MIC.Paths.tableSize)
+    {
+        unsigned int tableSize = (MIC.Paths.tableSize > 0)? MIC.Paths.tableSize*2 : PATH_TABLE_INITIAL_SIZE;
+        unsigned int *table = (unsigned int *)MIC_CALLOC(tableSize, sizeof(unsigned int));
+        if (table == NULL) return 0;
+
+        for (unsigned int id = 1; id <= MIC.Paths.count; id++)
+        {
+            unsigned int slot = micGetPathEntry(id)->hash & (tableSize - 1);
+            while (table[slot] != 0) slot = (slot + 1) & (tableSize - 1);
+            table[slot] = id;
+        }
+
+        MIC_FREE(MIC.Paths.table);
+        MIC.Paths.table = table;
+        MIC.Paths.tableSize = tableSize;
+    }
+
+    unsigned int id = MIC.Paths.count + 1;
+
+    if (MIC.Paths.pages == NULL) MIC.Paths.pages = (micPathEntry **)MIC_CALLOC(PATH_ENTRIES_MAX_PAGES, sizeof(micPathEntry *));
+    if (MIC.Paths.pages == NULL) return 0;
+
+    micPathEntry **page = &MIC.Paths.pages[id/PATH_ENTRIES_PAGE_SIZE];
+    if (*page == NULL) *page = (micPathEntry *)MIC_CALLOC(PATH_ENTRIES_PAGE_SIZE, sizeof(micPathEntry));
+    if (*page == NULL) return 0;
+
+    // Path string appended to last storage block, new block started if it does not fit
+    if ((MIC.Paths.blockCount == 0) || (MIC.Paths.blockUsed + length + 1 > MIC.Paths.blockSize))
+    {
+        if (MIC.Paths.blockCount == MIC.Paths.blockCapacity)
+        {
+            int capacity = (MIC.Paths.blockCapacity > 0)? MIC.Paths.blockCapacity*2 : 16;
+            char **blocks = (char **)MIC_REALLOC(MIC.Paths.blocks, capacity*sizeof(char *));
+            if (blocks == NULL) return 0;
+
+            MIC.Paths.blocks = blocks;
+            MIC.Paths.blockCapacity = capacity;
+        }
+
+        size_t blockSize = (length + 1 > PATH_STORAGE_BLOCK_SIZE)? length + 1 : PATH_STORAGE_BLOCK_SIZE;
+        char *block = (char *)MIC_MALLOC(blockSize);
+        if (block == NULL) return 0;
+
+        MIC.Paths.blocks[MIC.Paths.blockCount++] = block;
+        MIC.Paths.blockSize = blockSize;
+        MIC.Paths.blockUsed = 0;
+    }
+
+    char *string = MIC.Paths.blocks[MIC.Paths.blockCount - 1] + MIC.Paths.blockUsed;
+    memcpy(string, path, length);
+    string[length] = '\0';
+    MIC.Paths.blockUsed += length + 1;
+
+    micPathEntry *entry = &(*page)[id%PATH_ENTRIES_PAGE_SIZE];
+    entry->path = string;
+    entry->length = (unsigned int)length;
+    entry->hash = hash;
+    entry->parent = 0;
+
+    unsigned int slot = hash & (MIC.Paths.tableSize - 1);
+    while (MIC.Paths.table[slot] != 0) slot = (slot + 1) & (MIC.Paths.tableSize - 1);
+    MIC.Paths.table[slot] = id;
+
+    MIC.Paths.count = id;
+
+    return id;
+}
+
+// Normalize and intern path joined to a directory path (dirPath can be NULL), returns path id (0 if not found or not valid)
+static unsigned int micInternPathJoin(const char *dirPath, const char *path, bool insert)
+{
+    size_t dirLength = (dirPath != NULL)? strlen(dirPath) : 0;
+    size_t pathLength = strlen(path);
+    size_t length = (dirLength > 0)? dirLength + 1 + pathLength : pathLength;
+
+    // NOTE: Only very long paths require a temporary allocation
+    char buffer[MAX_FILEPATH_LENGTH] = { 0 };
+    char *joined = (length + 2 <= MAX_FILEPATH_LENGTH)? buffer : (char *)MIC_MALLOC(length + 2);
+    if (joined == NULL) return 0;
+
+    if (dirLength > 0)
+    {
+        memcpy(joined, dirPath, dirLength);
+        joined[dirLength] = '/';
+        memcpy(joined + dirLength + 1, path, pathLength);
+    }
+    else memcpy(joined, path, pathLength);
+
+    length = micNormalizePath(joined, length);
+
+#if !defined(_WIN32)
+    pthread_mutex_lock(&micPathsMutex);
+#endif
+    unsigned int id = micInternPathData(joined, length, insert);
+#if !defined(_WIN32)
+    pthread_mutex_unlock(&micPathsMutex);
+#endif
+
+    if (joined != buffer) MIC_FREE(joined);
+
+    return id;
+}
+
+// Normalize and intern full path of a path (relative paths resolved against working directory), returns path id
+static unsigned int micInternFullPath(const char *path)
+{
+    if (path == NULL) return 0;
+
+    bool absolute = IS_PATH_SEPARATOR(path[0]);
+#if defined(_WIN32)
+    if ((path[0] != '\0') && (path[1] == ':')) absolute = true;
+#endif
+    if (absolute) return micInternPathJoin(NULL, path, true);
+
+    char workingDir[MAX_FILEPATH_LENGTH] = { 0 };
+    if (GETCWD(workingDir, MAX_FILEPATH_LENGTH - 1) == NULL) return 0;
+
+    return micInternPathJoin(workingDir, path, true);
+}
+
+// File copy: directory entries, delta update, directory sync
+//----------------------------------------------------------------------------------
+
+// Load directory entries names (no "." or ".."), returns NULL if directory can not be read
+static char **micLoadDirectoryEntries(const char *dirPath, int *count)
+{
+    *count = 0;
+
+    int capacity = 64;
+    char **entries = (char **)MIC_MALLOC(capacity*sizeof(char *));
+    if (entries == NULL) return NULL;
+
+    bool success = true;
+
+#if defined(_WIN32)
+    char pattern[MAX_FILEPATH_LENGTH] = { 0 };
+    struct _finddata_t data = { 0 };
+    intptr_t handle = -1;
+
+    if (snprintf(pattern, MAX_FILEPATH_LENGTH, "%s/*", dirPath) < MAX_FILEPATH_LENGTH) handle = _findfirst(pattern, &data);
+    success = (handle != -1);
+
+    for (int found = success? 0 : -1; found == 0; found = _findnext(handle, &data))
+    {
+        const char *name = data.name;
+#else
+    DIR *dir = opendir(dirPath);
+    success = (dir != NULL);
+
+    for (struct dirent *entry = success? readdir(dir) : NULL; entry != NULL; entry = readdir(dir))
+    {
+        const char *name = entry->d_name;
+#endif
+        if ((name[0] == '.') && ((name[1] == '\0') || ((name[1] == '.') && (name[2] == '\0')))) continue;
+
+        if (*count == capacity)
+        {
+            char **grown = (char **)MIC_REALLOC(entries, 2*capacity*sizeof(char *));
+            if (grown == NULL) { success = false; break; }
+
+            entries = grown;
+            capacity *= 2;
+        }
+
+        size_t length = strlen(name);
+        entries[*count] = (char *)MIC_MALLOC(length + 1);
+        if (entries[*count] == NULL) { success = false; break; }
+
+        memcpy(entries[*count], name, length + 1);
+        (*count)++;
+    }
+
+#if defined(_WIN32)
+    if (handle != -1) _findclose(handle);
+#else
+    if (dir != NULL) closedir(dir);
+#endif
+
+    if (!success)
+    {
+        micUnloadDirectoryEntries(entries, *count);
+        *count = 0;
+        entries = NULL;
+    }
+
+    return entries;
+}
+
+// Unload directory entries names
+static void micUnloadDirectoryEntries(char **entries, int count)
+{
+    if (entries == NULL) return;
+
+    for (int i = 0; i < count; i++) MIC_FREE(entries[i]);
+    MIC_FREE(entries);
+}
+
+#if !defined(_WIN32)
+// Read data at file offset, retrying partial reads, returns bytes read (less than size at end of file or on error)
+static size_t micReadFileAt(int fd, void *data, size_t size, long long offset)
+{
+    size_t total = 0;
+
+    while (total < size)
+    {
+        ssize_t bytesRead = pread(fd, (unsigned char *)data + total, size - total, (off_t)(offset + total));
+
+        if (bytesRead < 0)
+        {
+            if (errno == EINTR) continue;
+            break;
+        }
+        else if (bytesRead == 0) break;
+
+        total += bytesRead;
+    }
+
+    return total;
+}
+
+// Write all data at file offset, retrying partial writes
+static bool micWriteFileAt(int fd, const void *data, size_t size, long long offset)
+{
+    size_t total = 0;
+
+    while (total < size)
+    {
+        ssize_t written = pwrite(fd, (const unsigned char *)data + total, size - total, (off_t)(offset + total));
+
+        if (written < 0)
+        {
+            if (errno == EINTR) continue;
+            return false;
+        }
+
+        total += written;
+    }
+
+    return true;
+}
+
+// Set file permissions and access/modification times from source file info
+// NOTE: Same modification time as source lets sync mode skip the file next time
+static void micSetFileAttributes(int fd, const struct stat *srcInfo)
+{
+#if defined(__APPLE__)
+    struct timespec times[2] = { srcInfo->st_atimespec, srcInfo->st_mtimespec };
+#else
+    struct timespec times[2] = { srcInfo->st_atim, srcInfo->st_mtim };
+#endif
+    fchmod(fd, srcInfo->st_mode & 07777);
+    futimens(fd, times);
+}
+#endif
+
+// Copy file whole to a temporary file renamed over destination, returns bytes written (-1 on failure)
+// NOTE: Synced as requested by micSetFileSyncMode(), same as micSaveFileData()
+static long long micCopyFileData(const char *srcFileName, const char *dstFileName, const struct stat *srcInfo)
+{
+    char tempFileName[MAX_FILEPATH_LENGTH] = { 0 };
+    long long written = 0;
+    bool success = false;
+
+#if defined(_WIN32)
+    if (snprintf(tempFileName, MAX_FILEPATH_LENGTH, "%s.mic%u", dstFileName, MIC_FETCH_INCREMENT(MIC.Sync.tempCounter)) >= MAX_FILEPATH_LENGTH) return -1;
+
+    FILE *srcFile = fopen(srcFileName, "rb");
+    FILE *dstFile = (srcFile != NULL)? fopen(tempFileName, "wb") : NULL;
+    unsigned char *buffer = (unsigned char *)MIC_MALLOC(COPY_CHUNK_SIZE);
+    success = (srcFile != NULL) && (dstFile != NULL) && (buffer != NULL);
+
+    while (success)
+    {
+        size_t bytesRead = fread(buffer, 1, COPY_CHUNK_SIZE, srcFile);
+        if (bytesRead == 0) { success = !ferror(srcFile); break; }
+
+        success = (fwrite(buffer, 1, bytesRead, dstFile) == bytesRead);
+        written += bytesRead;
+    }
+
+    if (success) success = (fflush(dstFile) == 0);
+    if (success && (CTX.syncMode != MIC_FILE_SYNC_NONE)) success = (_commit(_fileno(dstFile)) == 0);
+
+    if (srcFile != NULL) fclose(srcFile);
+    if (dstFile != NULL) fclose(dstFile);
+    MIC_FREE(buffer);
+
+    if (success) success = (MoveFileExA(tempFileName, dstFileName, 0x1 | 0x8) != 0);  // MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH
+    if (!success && (dstFile != NULL)) remove(tempFileName);
+
+    if (success)
+    {
+        struct _utimbuf times = { srcInfo->st_atime, srcInfo->st_mtime };
+        _utime(dstFileName, &times);
+    }
+#else
+    if (snprintf(tempFileName, MAX_FILEPATH_LENGTH, "%s.XXXXXX", dstFileName) >= MAX_FILEPATH_LENGTH) return -1;
+
+    char dirPath[MAX_FILEPATH_LENGTH] = { 0 };
+    micGetParentDirectory(dstFileName, dirPath);
+
+    int srcFd = open(srcFileName, O_RDONLY | O_CLOEXEC);
+    int dstFd = (srcFd >= 0)? mkstemp(tempFileName) : -1;
+    success = (srcFd >= 0) && (dstFd >= 0);
+
+#if defined(__linux__) && defined(__NR_copy_file_range)
+    // Data copied by the kernel, no round trip through user space (shared extents on filesystems supporting it)
+    while (success && (written < (long long)srcInfo->st_size))
+    {
+        ssize_t copied = syscall(__NR_copy_file_range, srcFd, NULL, dstFd, NULL, (size_t)(srcInfo->st_size - written), 0);
+
+        if ((copied < 0) && (errno == EINTR)) continue;
+        if (copied <= 0) break;     // Not supported (kernel, filesystems) or source shortened: copy continued below
+
+        written += copied;
+    }
+#endif
+
+    if (success)
+    {
+        // Copy remaining data (everything if kernel copy not available), until source end of file
+        unsigned char *buffer = (unsigned char *)MIC_MALLOC(COPY_CHUNK_SIZE);
+        success = (buffer != NULL);
+
+        while (success)
+        {
+            ssize_t bytesRead = read(srcFd, buffer, COPY_CHUNK_SIZE);
+
+            if (bytesRead < 0)
+            {
+                if (errno == EINTR) continue;
+                success = false;
+            }
+            else if (bytesRead == 0) break;
+            else
+            {
+                success = micWriteFileDescriptor(dstFd, buffer, bytesRead);
+                written += bytesRead;
+            }
+        }
+
+        MIC_FREE(buffer);
+    }
+
+    if (success) micSetFileAttributes(dstFd, srcInfo);
+    if (success && (CTX.syncMode == MIC_FILE_SYNC_IMMEDIATE)) success = (FDATASYNC(dstFd) == 0);
+
+    if (success) success = (rename(tempFileName, dstFileName) == 0);
+    if (!success && (dstFd >= 0)) unlink(tempFileName);
+
+    if (success)
+    {
+        if (CTX.syncMode == MIC_FILE_SYNC_IMMEDIATE) success = micSyncDirectory(dirPath);
+        else if (CTX.syncMode == MIC_FILE_SYNC_BATCHED) success = micAddPendingSync(dstFd, dstFileName, dirPath);
+    }
+
+    if (srcFd >= 0) close(srcFd);
+    if (dstFd >= 0) close(dstFd);
+#endif
+
+    return success? written : -1;
+}
+
+#if !defined(_WIN32)
+// Update file in place, only changed blocks written, returns bytes written (-1 on failure)
+// NOTE: Both files are local, blocks compared at same offsets: data inserted or removed shifts
+// all following blocks and they are rewritten anyway, searching moved blocks (rolling checksum)
+// would not save any write. Destination modification time is only set at the end, an interrupted
+// update is never taken as unchanged
+static long long micUpdateFileData(const char *srcFileName, const char *dstFileName, const struct stat *srcInfo)
+{
+    int srcFd = open(srcFileName, O_RDONLY | O_CLOEXEC);
+    int dstFd = (srcFd >= 0)? open(dstFileName, O_RDWR | O_CLOEXEC) : -1;
+    unsigned char *srcBuffer = (unsigned char *)MIC_MALLOC(2*COPY_CHUNK_SIZE);
+    unsigned char *dstBuffer = srcBuffer + COPY_CHUNK_SIZE;
+
+    bool success = (srcFd >= 0) && (dstFd >= 0) && (srcBuffer != NULL);
+    long long size = (long long)srcInfo->st_size;
+    long long written = 0;
+
+    for (long long offset = 0; success && (offset < size); offset += COPY_CHUNK_SIZE)
+    {
+        size_t chunkSize = ((size - offset) < COPY_CHUNK_SIZE)? (size_t)(size - offset) : COPY_CHUNK_SIZE;
+        size_t srcRead = micReadFileAt(srcFd, srcBuffer, chunkSize, offset);
+        size_t dstRead = micReadFileAt(dstFd, dstBuffer, chunkSize, offset);
+
+        // Source file changed while copied
+        if (srcRead != chunkSize) { success = false; break; }
+
+        // Consecutive changed blocks written at once
+        size_t runStart = chunkSize;
+
+        for (size_t block = 0; success && (block < chunkSize); block += COPY_BLOCK_SIZE)
+        {
+            size_t blockSize = ((chunkSize - block) < COPY_BLOCK_SIZE)? (chunkSize - block) : COPY_BLOCK_SIZE;
+            bool changed = ((block + blockSize) > dstRead) || (memcmp(srcBuffer + block, dstBuffer + block, blockSize) != 0);
+
+            if (changed && (runStart == chunkSize)) runStart = block;
+            else if (!changed && (runStart < chunkSize))
+            {
+                success = micWriteFileAt(dstFd, srcBuffer + runStart, block - runStart, offset + runStart);
+                written += block - runStart;
+                runStart = chunkSize;
+            }
+        }
+
+        if (success && (runStart < chunkSize))
+        {
+            success = micWriteFileAt(dstFd, srcBuffer + runStart, chunkSize - runStart, offset + runStart);
+            written += chunkSize - runStart;
+        }
+    }
+
+    if (success) success = (ftruncate(dstFd, (off_t)size) == 0);
+    if (success) micSetFileAttributes(dstFd, srcInfo);
+
+    if (success)
+    {
+        char dirPath[MAX_FILEPATH_LENGTH] = { 0 };
+        micGetParentDirectory(dstFileName, dirPath);
+
+        if (CTX.syncMode == MIC_FILE_SYNC_IMMEDIATE) success = (FDATASYNC(dstFd) == 0);
+        else if (CTX.syncMode == MIC_FILE_SYNC_BATCHED) success = micAddPendingSync(dstFd, dstFileName, dirPath);
+    }
+
+    if (srcFd >= 0) close(srcFd);
+    if (dstFd >= 0) close(dstFd);
+    MIC_FREE(srcBuffer);
+
+    return success? written : -1;
+}
+#endif
+
+// Copy one file (copy flags applied), returns enum micCopyResult
+static int micCopyFileEntry(const char *srcFileName, const char *dstFileName, const struct stat *srcInfo, long long *written)
+{
+    struct stat dstInfo = { 0 };
+    *written = 0;
+
+    if ((CTX.copyFlags & MIC_COPY_SYNC) && (stat(dstFileName, &dstInfo) == 0) && S_ISREG(dstInfo.st_mode))
+    {
+        micFileInfo srcFile = { 0 };
+        micFileInfo dstFile = { 0 };
+        micFillFileInfo(&srcFile, srcInfo);
+        micFillFileInfo(&dstFile, &dstInfo);
+
+        if ((srcFile.size == dstFile.size) && (srcFile.modTime == dstFile.modTime)) return MIC_COPY_RESULT_SKIPPED;
+
+#if !defined(_WIN32)
+        // Big files updated in place (hard linked files replaced instead, other names keep their data)
+        if ((srcFile.size >= COPY_DELTA_MIN_SIZE) && (dstInfo.st_nlink == 1))
+        {
+            *written = micUpdateFileData(srcFileName, dstFileName, srcInfo);
+            if (*written >= 0) return MIC_COPY_RESULT_UPDATED;
+        }
+#endif
+    }
+
+    *written = micCopyFileData(srcFileName, dstFileName, srcInfo);
+    if (*written < 0) *written = 0;
+    else return MIC_COPY_RESULT_COPIED;
+
+    return MIC_COPY_RESULT_FAILED;
+}
+
+// Create destination directories (links copied), collect files to copy, returns entries failed
+// NOTE: Destination entries of another type than source entries are removed first
+static int micCollectCopyJobs(micCopyJobs *jobs, const char *srcDirPath, const char *dstDirPath)
+{
+    int count = 0;
+    char **entries = micLoadDirectoryEntries(srcDirPath, &count);
+
+    if (entries == NULL)
+    {
+        micTraceLog(MIC_LOG_WARNING, "[%s] Directory could not be read", srcDirPath);
+        return 1;
+    }
+
+    char srcPath[MAX_FILEPATH_LENGTH] = { 0 };
+    char dstPath[MAX_FILEPATH_LENGTH] = { 0 };
+    int failed = 0;
+
+    for (int i = 0; i < count; i++)
+    {
+        struct stat srcInfo = { 0 };
+        struct stat dstInfo = { 0 };
+
+        if ((snprintf(srcPath, MAX_FILEPATH_LENGTH, "%s/%s", srcDirPath, entries[i]) >= MAX_FILEPATH_LENGTH) ||
+            (snprintf(dstPath, MAX_FILEPATH_LENGTH, "%s/%s", dstDirPath, entries[i]) >= MAX_FILEPATH_LENGTH))
+        {
+            micTraceLog(MIC_LOG_WARNING, "[%s] File path too long to copy file", entries[i]);
+            failed++;
+            continue;
+        }
+
+#if defined(_WIN32)
+        if (stat(srcPath, &srcInfo) != 0) { failed++; continue; }
+        bool dstAvailable = (stat(dstPath, &dstInfo) == 0);
+#else
+        if (lstat(srcPath, &srcInfo) != 0) { failed++; continue; }
+        bool dstAvailable = (lstat(dstPath, &dstInfo) == 0);
+#endif
+
+        if (S_ISDIR(srcInfo.st_mode))
+        {
+            if (dstAvailable && !S_ISDIR(dstInfo.st_mode))
+            {
+                if (!micRemovePathTree(dstPath)) { failed++; continue; }
+                dstAvailable = false;
+            }
+
+#if defined(_WIN32)
+            if (!dstAvailable && (_mkdir(dstPath) != 0))
+#else
+            if (!dstAvailable && (mkdir(dstPath, (srcInfo.st_mode & 07777) | S_IRWXU) != 0))
+#endif
+            {
+                micTraceLog(MIC_LOG_WARNING, "[%s] Directory could not be created", dstPath);
+                failed++;
+                continue;
+            }
+
+            failed += micCollectCopyJobs(jobs, srcPath, dstPath);
+        }
+        else if (S_ISREG(srcInfo.st_mode))
+        {
+            // Destination links replaced, not followed
+            if (dstAvailable && !S_ISREG(dstInfo.st_mode) && !micRemovePathTree(dstPath)) { failed++; continue; }
+
+            if (jobs->count == jobs->capacity)
+            {
+                int capacity = (jobs->capacity > 0)? 2*jobs->capacity : 256;
+                char **srcFileNames = (char **)MIC_REALLOC(jobs->srcFileNames, capacity*sizeof(char *));
+                if (srcFileNames != NULL) jobs->srcFileNames = srcFileNames;
+                char **dstFileNames = (char **)MIC_REALLOC(jobs->dstFileNames, capacity*sizeof(char *));
+                if (dstFileNames != NULL) jobs->dstFileNames = dstFileNames;
+
+                if ((srcFileNames == NULL) || (dstFileNames == NULL)) { failed++; continue; }
+                jobs->capacity = capacity;
+            }
+
+            size_t srcLength = strlen(srcPath) + 1;
+            size_t dstLength = strlen(dstPath) + 1;
+            char *srcFileName = (char *)MIC_MALLOC(srcLength);
+            char *dstFileName = (char *)MIC_MALLOC(dstLength);
+
+            if ((srcFileName == NULL) || (dstFileName == NULL))
+            {
+                MIC_FREE(srcFileName);
+                MIC_FREE(dstFileName);
+                failed++;
+                continue;
+            }
+
+            memcpy(srcFileName, srcPath, srcLength);
+            memcpy(dstFileName, dstPath, dstLength);
+            jobs->srcFileNames[jobs->count] = srcFileName;
+            jobs->dstFileNames[jobs->count] = dstFileName;
+            jobs->count++;
+        }
+#if !defined(_WIN32)
+        else if (S_ISLNK(srcInfo.st_mode))
+        {
+            // Links copied as links, target not changed
+            char target[MAX_FILEPATH_LENGTH] = { 0 };
+            char current[MAX_FILEPATH_LENGTH] = { 0 };
+
+            ssize_t length = readlink(srcPath, target, MAX_FILEPATH_LENGTH - 1);
+            if (length < 0) { failed++; continue; }
+
+            if (dstAvailable && S_ISLNK(dstInfo.st_mode) && (readlink(dstPath, current, MAX_FILEPATH_LENGTH - 1) == length) &&
+                (memcmp(target, current, length) == 0)) continue;
+
+            if ((dstAvailable && !micRemovePathTree(dstPath)) || (symlink(target, dstPath) != 0))
+            {
+                micTraceLog(MIC_LOG_WARNING, "[%s] Link could not be created", dstPath);
+                failed++;
+            }
+        }
+#endif
+        // NOTE: Special files (devices, pipes, sockets) are not copied
+    }
+
+    micUnloadDirectoryEntries(entries, count);
+
+    return failed;
+}
+
+// Copy one file (job for micRunParallel())
+static void micCopyFileJob(void *userData, int index)
+{
+    micCopyJobs *jobs = (micCopyJobs *)userData;
+    struct stat srcInfo = { 0 };
+
+    if (stat(jobs->srcFileNames[index], &srcInfo) != 0) jobs->results[index] = MIC_COPY_RESULT_FAILED;
+    else jobs->results[index] = micCopyFileEntry(jobs->srcFileNames[index], jobs->dstFileNames[index], &srcInfo, &jobs->written[index]);
+}
+
+// Remove file, link or directory with all its content
+static bool micRemovePathTree(const char *path)
+{
+    struct stat info = { 0 };
+
+#if defined(_WIN32)
+    if (stat(path, &info) != 0) return false;
+#else
+    if (lstat(path, &info) != 0) return false;
+#endif
+
+    if (!S_ISDIR(info.st_mode)) return (remove(path) == 0);
+
+    int count = 0;
+    char **entries = micLoadDirectoryEntries(path, &count);
+    if (entries == NULL) return false;
+
+    char entryPath[MAX_FILEPATH_LENGTH] = { 0 };
+    bool success = true;
+
+    for (int i = 0; (i < count) && success; i++)
+    {
+        success = (snprintf(entryPath, MAX_FILEPATH_LENGTH, "%s/%s", path, entries[i]) < MAX_FILEPATH_LENGTH) && micRemovePathTree(entryPath);
+    }
+
+    micUnloadDirectoryEntries(entries, count);
+
+#if defined(_WIN32)
+    return success && (_rmdir(path) == 0);
+#else
+    return success && (rmdir(path) == 0);
+#endif
+}
+
+// Delete destination entries not available in source, returns entries deleted
+static int micDeleteExtraneousEntries(const char *srcDirPath, const char *dstDirPath, int *failed)
+{
+    int count = 0;
+    char **entries = micLoadDirectoryEntries(dstDirPath, &count);
+    if (entries == NULL) return 0;
+
+    char srcPath[MAX_FILEPATH_LENGTH] = { 0 };
+    char dstPath[MAX_FILEPATH_LENGTH] = { 0 };
+    int deleted = 0;
+
+    for (int i = 0; i < count; i++)
+    {
+        if ((snprintf(srcPath, MAX_FILEPATH_LENGTH, "%s/%s", srcDirPath, entries[i]) >= MAX_FILEPATH_LENGTH) ||
+            (snprintf(dstPath, MAX_FILEPATH_LENGTH, "%s/%s", dstDirPath, entries[i]) >= MAX_FILEPATH_LENGTH)) continue;
+
+        struct stat srcInfo = { 0 };
+        struct stat dstInfo = { 0 };
+
+#if defined(_WIN32)
+        bool srcAvailable = (stat(srcPath, &srcInfo) == 0);
+        if (stat(dstPath, &dstInfo) != 0) continue;
+#else
+        bool srcAvailable = (lstat(srcPath, &srcInfo) == 0);
+        if (lstat(dstPath, &dstInfo) != 0) continue;
+#endif
+
+        if (!srcAvailable)
+        {
+            if (micRemovePathTree(dstPath)) deleted++;
+            else
+            {
+                micTraceLog(MIC_LOG_WARNING, "[%s] Extraneous entry could not be deleted", dstPath);
+                (*failed)++;
+            }
+        }
+        else if (S_ISDIR(srcInfo.st_mode) && S_ISDIR(dstInfo.st_mode)) deleted += micDeleteExtraneousEntries(srcPath, dstPath, failed);
+    }
+
+    micUnloadDirectoryEntries(entries, count);
+
+    return deleted;
+}
+
+// Compression: DEFLATE encoding (deflate)
+//----------------------------------------------------------------------------------
+
+// Get match distance symbol (distances up to 256 directly, bigger ones by 128 bytes steps)
+static inline int micGetDeflateDistanceCode(const micDeflateState *state, unsigned int distance)
+{
+    return (distance <= 256)? state->distanceCodes[distance - 1] : state->distanceCodes[256 + ((distance - 1) >> 7)];
+}
+
+// Reserve compressed data space for size more bytes
+static bool micReserveDeflateOutput(micDeflateState *state, size_t size)
+{
+    if ((state->dstSize + size) <= state->dstCapacity) return true;
+
+    size_t capacity = (state->dstCapacity > 0)? state->dstCapacity : 4096;
+    while (capacity < (state->dstSize + size)) capacity *= 2;
+
+    unsigned char *dst = (unsigned char *)MIC_REALLOC(state->dst, capacity);
+    if (dst == NULL)
+    {
+        state->error = true;
+        return false;
+    }
+
+    state->dst = dst;
+    state->dstCapacity = capacity;
+
+    return true;
+}
+
+// Write bits to compressed data (LSB first), space must be reserved
+static inline void micWriteDeflateBits(micDeflateState *state, unsigned int value, int count)
+{
+    state->bitBuffer |= (uint64_t)value << state->bitCount;
+    state->bitCount += count;
+
+    if (state->bitCount >= 32)
+    {
+        unsigned char *dst = state->dst + state->dstSize;
+        dst[0] = (unsigned char)state->bitBuffer;
+        dst[1] = (unsigned char)(state->bitBuffer >> 8);
+        dst[2] = (unsigned char)(state->bitBuffer >> 16);
+        dst[3] = (unsigned char)(state->bitBuffer >> 24);
+
+        state->dstSize += 4;
+        state->bitBuffer >>= 32;
+        state->bitCount -= 32;
+    }
+}
+
+// Write remaining bits to compressed data, padded to a byte boundary
+static void micFlushDeflateBits(micDeflateState *state)
+{
+    while (state->bitCount > 0)
+    {
+        state->dst[state->dstSize++] = (unsigned char)state->bitBuffer;
+        state->bitBuffer >>= 8;
+        state->bitCount -= 8;
+    }
+
+    state->bitBuffer = 0;
+    state->bitCount = 0;
+}
+
+// Find longest match at position (hash chains), returns 0 if none longer than minLength
+// NOTE: Position must be inserted in hash chains already, data after position is at least 3 bytes
+static int micFindDeflateMatch(micDeflateState *state, size_t position, int minLength, unsigned int *distance)
+{
+    const unsigned char *src = state->src;
+    size_t available = state->srcSize - position;
+    int maxLength = (available < 258)? (int)available : 258;
+
+    int best = (minLength < 2)? 2 : minLength;
+    if (best >= maxLength) return 0;
+
+    int chain = (minLength >= DEFLATE_GOOD_LENGTH)? DEFLATE_MAX_CHAIN/4 : DEFLATE_MAX_CHAIN;
+    unsigned int candidate = state->prev[position & (DEFLATE_WINDOW_SIZE - 1)];
+    unsigned int bestDistance = 0;
+
+    while ((candidate > 0) && (chain-- > 0))
+    {
+        size_t match = candidate - 1;
+        if ((position - match) > DEFLATE_WINDOW_SIZE) break;
+
+        // Quick rejection: byte that would make the match longer than best, then first bytes
+        if ((src[match + best] == src[position + best]) && (src[match] == src[position]) && (src[match + 1] == src[position + 1]))
+        {
+            int length = 2;
+
+            while ((length + 8) <= maxLength)
+            {
+                uint64_t difference = micReadLE64(src + match + length) ^ micReadLE64(src + position + length);
+                if (difference != 0)
+                {
+#if defined(__GNUC__) || defined(__clang__)
+                    length += __builtin_ctzll(difference)/8;
+#else
+                    while ((difference & 0xff) == 0) { difference >>= 8; length++; }
+#endif
+                    goto compared;
+                }
+
+                length += 8;
+            }
+
+            while ((length < maxLength) && (src[match + length] == src[position + length])) length++;
+
+        compared:
+            if (length > best)
+            {
+                best = length;
+                bestDistance = (unsigned int)(position - match);
+                if ((length >= maxLength) || (length >= DEFLATE_NICE_LENGTH)) break;
+            }
+        }
+
+        // Link slot reused by a newer position: chain ends
+        unsigned int next = state->prev[match & (DEFLATE_WINDOW_SIZE - 1)];
+        if (next >= candidate) break;
+        candidate = next;
+    }
+
+    *distance = bestDistance;
+
+    return (bestDistance > 0)? best : 0;
+}
+
+// Build length limited Huffman code lengths from symbols frequencies (unused symbols get 0)
+// NOTE: Frequencies are halved until the longest code fits in maxBits
+static void micBuildDeflateLengths(const unsigned int *freqs, int count, int maxBits, unsigned char *lengths)
+{
+    unsigned int scaled[288] = { 0 };
+    unsigned int nodeFreqs[2*288] = { 0 };
+    int parents[2*288] = { 0 };
+    int depths[2*288] = { 0 };
+    int leaves[288] = { 0 };
+
+    memcpy(scaled, freqs, count*sizeof(unsigned int));
+
+    while (true)
+    {
+        int leafCount = 0;
+
+        for (int i = 0; i < count; i++)
+        {
+            lengths[i] = 0;
+            if (scaled[i] > 0) leaves[leafCount++] = i;
+        }
+
+        if (leafCount == 0) return;
+        if (leafCount == 1)
+        {
+            lengths[leaves[0]] = 1;
+            return;
+        }
+
+        // Leaves sorted by frequency (insertion sort, few symbols)
+        for (int i = 1; i < leafCount; i++)
+        {
+            int leaf = leaves[i];
+            int j = i;
+
+            for (; (j > 0) && (scaled[leaves[j - 1]] > scaled[leaf]); j--) leaves[j] = leaves[j - 1];
+            leaves[j] = leaf;
+        }
+
+        for (int i = 0; i < leafCount; i++) nodeFreqs[i] = scaled[leaves[i]];
+
+        // Two queues: sorted leaves and internal nodes (created in increasing frequency order)
+        int nextLeaf = 0;
+        int nextNode = leafCount;
+        int nodeCount = leafCount;
+
+        while (nodeCount < (2*leafCount - 1))
+        {
+            int children[2] = { 0 };
+
+            for (int k = 0; k < 2; k++)
+            {
+                if ((nextLeaf < leafCount) && ((nextNode >= nodeCount) || (nodeFreqs[nextLeaf] <= nodeFreqs[nextNode]))) children[k] = nextLeaf++;
+                else children[k] = nextNode++;
+            }
+
+            nodeFreqs[nodeCount] = nodeFreqs[children[0]] + nodeFreqs[children[1]];
+            parents[children[0]] = nodeCount;
+            parents[children[1]] = nodeCount;
+            nodeCount++;
+        }
+
+        // Depths from root (last node), parents are always after children
+        int maxDepth = 0;
+        depths[nodeCount - 1] = 0;
+
+        for (int i = nodeCount - 2; i >= 0; i--)
+        {
+            depths[i] = depths[parents[i]] + 1;
+            if ((i < leafCount) && (depths[i] > maxDepth)) maxDepth = depths[i];
+        }
+
+        if (maxDepth <= maxBits)
+        {
+            for (int i = 0; i < leafCount; i++) lengths[leaves[i]] = (unsigned char)depths[i];
+            return;
+        }
+
+        for (int i = 0; i < count; i++) if (scaled[i] > 0) scaled[i] = (scaled[i] >> 1) | 1;
+    }
+}
+
+// Build canonical Huffman codes from code lengths (bit reversed, LSB first)
+static void micBuildDeflateCodes(const unsigned char *lengths, int count, unsigned short *codes)
+{
+    int lengthCounts[16] = { 0 };
+    int nextCodes[16] = { 0 };
+
+    for (int i = 0; i < count; i++) lengthCounts[lengths[i]]++;
+    lengthCounts[0] = 0;
+
+    for (int len = 1, code = 0; len < 16; len++)
+    {
+        code = (code + lengthCounts[len - 1]) << 1;
+        nextCodes[len] = code;
+    }
+
+    for (int i = 0; i < count; i++)
+    {
+        codes[i] = 0;
+        if (lengths[i] == 0) continue;
+
+        unsigned int code = nextCodes[lengths[i]]++;
+        unsigned int reversed = 0;
+        for (int bit = 0; bit < lengths[i]; bit++) reversed |= ((code >> bit) & 1) << (lengths[i] - 1 - bit);
+
+        codes[i] = (unsigned short)reversed;
+    }
+}
+
+// Write block with collected symbols, dynamic codes, fixed codes or stored data (smallest)
+static void micWriteDeflateBlock(micDeflateState *state, bool last)
+{
+    static const unsigned char repeatExtra[3] = { 2, 3, 7 };   // Code lengths repeat symbols (16, 17, 18) extra bits
+
+    state->lengthFreqs[256] = 1;    // End of block
+
+    // Dynamic codes
+    unsigned char lengthLengths[288] = { 0 };
+    unsigned char distanceLengths[30] = { 0 };
+    micBuildDeflateLengths(state->lengthFreqs, 286, 15, lengthLengths);
+    micBuildDeflateLengths(state->distanceFreqs, 30, 15, distanceLengths);
+
+    int lengthCount = 286;
+    while ((lengthCount > 257) && (lengthLengths[lengthCount - 1] == 0)) lengthCount--;
+    int distanceCount = 30;
+    while ((distanceCount > 1) && (distanceLengths[distanceCount - 1] == 0)) distanceCount--;
+
+    // Code lengths run length encoded: 16 (repeat previous 3-6), 17 (zeros 3-10), 18 (zeros 11-138)
+    unsigned char codeLengths[286 + 30] = { 0 };
+    memcpy(codeLengths, lengthLengths, lengthCount);
+    memcpy(codeLengths + lengthCount, distanceLengths, distanceCount);
+
+    unsigned char runSymbols[286 + 30] = { 0 };
+    unsigned char runExtras[286 + 30] = { 0 };
+    unsigned int runFreqs[19] = { 0 };
+    int runCount = 0;
+
+    for (int i = 0, total = lengthCount + distanceCount; i < total;)
+    {
+        unsigned char value = codeLengths[i];
+        int run = 1;
+        while (((i + run) < total) && (codeLengths[i + run] == value)) run++;
+
+        if ((value == 0) && (run >= 3))
+        {
+            if (run > 138) run = 138;
+            runSymbols[runCount] = (run >= 11)? 18 : 17;
+            runExtras[runCount] = (unsigned char)((run >= 11)? (run - 11) : (run - 3));
+        }
+        else if ((i > 0) && (codeLengths[i - 1] == value) && (run >= 3))
+        {
+            if (run > 6) run = 6;
+            runSymbols[runCount] = 16;
+            runExtras[runCount] = (unsigned char)(run - 3);
+        }
+        else
+        {
+            run = 1;
+            runSymbols[runCount] = value;
+        }
+
+        runFreqs[runSymbols[runCount]]++;
+        runCount++;
+        i += run;
+    }
+
+    unsigned char runLengths[19] = { 0 };
+    micBuildDeflateLengths(runFreqs, 19, 7, runLengths);
+
+    int runCodeCount = 19;
+    while ((runCodeCount > 4) && (runLengths[micCodeLengthsOrder[runCodeCount - 1]] == 0)) runCodeCount--;
+
+    // Blocks sizes in bits
+    unsigned long long dynamicBits = 3 + 5 + 5 + 4 + 3*runCodeCount;
+    unsigned long long fixedBits = 3;
+    unsigned long long extraBits = 0;
+
+    for (int i = 0; i < runCount; i++) dynamicBits += runLengths[runSymbols[i]] + ((runSymbols[i] >= 16)? repeatExtra[runSymbols[i] - 16] : 0);
+
+    for (int i = 0; i < 286; i++)
+    {
+        unsigned long long freq = state->lengthFreqs[i];
+        dynamicBits += freq*lengthLengths[i];
+        fixedBits += freq*((i < 144)? 8 : (i < 256)? 9 : (i < 280)? 7 : 8);
+        if (i > 256) extraBits += freq*micLengthExtra[i - 257];
+    }
+
+    for (int i = 0; i < 30; i++)
+    {
+        unsigned long long freq = state->distanceFreqs[i];
+        dynamicBits += freq*distanceLengths[i];
+        fixedBits += freq*5;
+        extraBits += freq*micDistanceExtra[i];
+    }
+
+    dynamicBits += extraBits;
+    fixedBits += extraBits;
+
+    size_t storedCount = (state->blockLength + 65534)/65535;
+    if (storedCount == 0) storedCount = 1;
+    unsigned long long storedBits = (unsigned long long)state->blockLength*8 + storedCount*(3 + 7 + 32);
+
+    if ((storedBits <= dynamicBits) && (storedBits <= fixedBits))
+    {
+        // Stored blocks: data copied, 65535 bytes per block maximum
+        if (micReserveDeflateOutput(state, state->blockLength + storedCount*5 + 16))
+        {
+            const unsigned char *data = state->src + state->blockStart;
+            size_t remaining = state->blockLength;
+
+            do
+            {
+                size_t length = (remaining < 65535)? remaining : 65535;
+                remaining -= length;
+
+                micWriteDeflateBits(state, (last && (remaining == 0))? 1 : 0, 1);
+                micWriteDeflateBits(state, 0, 2);
+                micFlushDeflateBits(state);
+
+                unsigned char *dst = state->dst + state->dstSize;
+                dst[0] = (unsigned char)length;
+                dst[1] = (unsigned char)(length >> 8);
+                dst[2] = (unsigned char)~length;
+                dst[3] = (unsigned char)(~length >> 8);
+                memcpy(dst + 4, data, length);
+
+                state->dstSize += length + 4;
+                data += length;
+            } while (remaining > 0);
+        }
+    }
+    else if (micReserveDeflateOutput(state, (size_t)(((dynamicBits < fixedBits)? dynamicBits : fixedBits)/8) + 16))
+    {
+        unsigned short lengthCodes[288] = { 0 };
+        unsigned short distanceCodes[30] = { 0 };
+
+        if (fixedBits <= dynamicBits)
+        {
+            for (int i = 0; i < 288; i++) lengthLengths[i] = (i < 144)? 8 : (i < 256)? 9 : (i < 280)? 7 : 8;
+            for (int i = 0; i < 30; i++) distanceLengths[i] = 5;
+
+            micWriteDeflateBits(state, last? 1 : 0, 1);
+            micWriteDeflateBits(state, 1, 2);
+            micBuildDeflateCodes(lengthLengths, 288, lengthCodes);
+            micBuildDeflateCodes(distanceLengths, 30, distanceCodes);
+        }
+        else
+        {
+            unsigned short runCodes[19] = { 0 };
+            micBuildDeflateCodes(runLengths, 19, runCodes);
+
+            micWriteDeflateBits(state, last? 1 : 0, 1);
+            micWriteDeflateBits(state, 2, 2);
+            micWriteDeflateBits(state, lengthCount - 257, 5);
+            micWriteDeflateBits(state, distanceCount - 1, 5);
+            micWriteDeflateBits(state, runCodeCount - 4, 4);
+            for (int i = 0; i < runCodeCount; i++) micWriteDeflateBits(state, runLengths[micCodeLengthsOrder[i]], 3);
+
+            for (int i = 0; i < runCount; i++)
+            {
+                micWriteDeflateBits(state, runCodes[runSymbols[i]], runLengths[runSymbols[i]]);
+                if (runSymbols[i] >= 16) micWriteDeflateBits(state, runExtras[i], repeatExtra[runSymbols[i] - 16]);
+            }
+
+            micBuildDeflateCodes(lengthLengths, 286, lengthCodes);
+            micBuildDeflateCodes(distanceLengths, 30, distanceCodes);
+        }
+
+        for (int i = 0; i < state->symbolCount; i++)
+        {
+            unsigned int symbol = state->symbols[i];
+
+            if (symbol < 256) micWriteDeflateBits(state, lengthCodes[symbol], lengthLengths[symbol]);
+            else
+            {
+                unsigned int length = symbol & 0xffff;
+                unsigned int distance = symbol >> 16;
+                int lengthCode = state->lengthCodes[length];
+                int distanceCode = micGetDeflateDistanceCode(state, distance);
+
+                micWriteDeflateBits(state, lengthCodes[257 + lengthCode], lengthLengths[257 + lengthCode]);
+                if (micLengthExtra[lengthCode] > 0) micWriteDeflateBits(state, length - micLengthBase[lengthCode], micLengthExtra[lengthCode]);
+
+                micWriteDeflateBits(state, distanceCodes[distanceCode], distanceLengths[distanceCode]);
+                if (micDistanceExtra[distanceCode] > 0) micWriteDeflateBits(state, distance - micDistanceBase[distanceCode], micDistanceExtra[distanceCode]);
+            }
+        }
+
+        micWriteDeflateBits(state, lengthCodes[256], lengthLengths[256]);
+    }
+
+    // Next block starts after block data
+    state->blockStart += state->blockLength;
+    state->blockLength = 0;
+    state->symbolCount = 0;
+    memset(state->lengthFreqs, 0, sizeof(state->lengthFreqs));
+    memset(state->distanceFreqs, 0, sizeof(state->distanceFreqs));
+}
+
+// Compress data into raw DEFLATE stream (hash chains, lazy matching), returns NULL on failure
+// NOTE: Every block gets the smallest encoding: dynamic Huffman codes, fixed codes or stored data
+static unsigned char *micDeflate(const unsigned char *data, size_t size, size_t *compSize)
+{
+    *compSize = 0;
+    if (((data == NULL) && (size > 0)) || (size >= 0xffffffff)) return NULL;
+
+    micDeflateState *state = (micDeflateState *)MIC_CALLOC(1, sizeof(micDeflateState));
+    if (state == NULL) return NULL;
+
+    state->src = data;
+    state->srcSize = size;
+    state->head = (unsigned int *)MIC_CALLOC(1 << DEFLATE_HASH_BITS, sizeof(unsigned int));
+    state->prev = (unsigned int *)MIC_CALLOC(DEFLATE_WINDOW_SIZE, sizeof(unsigned int));
+    state->symbols = (unsigned int *)MIC_MALLOC(DEFLATE_BLOCK_SYMBOLS*sizeof(unsigned int));
+    state->error = (state->head == NULL) || (state->prev == NULL) || (state->symbols == NULL) || !micReserveDeflateOutput(state, size/4 + 64);
+
+    // Length and distance symbols lookup
+    for (int code = 0; code < 29; code++)
+    {
+        for (int length = micLengthBase[code]; (length < (micLengthBase[code] + (1 << micLengthExtra[code]))) && (length <= 258); length++) state->lengthCodes[length] = (unsigned char)code;
+    }
+
+    for (int code = 0; code < 30; code++)
+    {
+        for (int distance = micDistanceBase[code]; distance < (micDistanceBase[code] + (1 << micDistanceExtra[code])); distance += (distance <= 256)? 1 : 128)
+        {
+            if (distance <= 256) state->distanceCodes[distance - 1] = (unsigned char)code;
+            else state->distanceCodes[256 + ((distance - 1) >> 7)] = (unsigned char)code;
+        }
+    }
+
+    // LZ77 with lazy matching: match found at a position is only taken if next position has no longer match
+    size_t position = 0;
+    int prevLength = 0;             // Match found at previous position (0: none)
+    unsigned int prevDistance = 0;
+    bool literalPending = false;    // Previous position byte not emitted yet
+
+    while (!state->error && (position < size))
+    {
+        int length = 0;
+        unsigned int distance = 0;
+
+        if ((position + 3) <= size)
+        {
+            unsigned int hash = ((data[position] | (data[position + 1] << 8) | (data[position + 2] << 16))*2654435761u) >> (32 - DEFLATE_HASH_BITS);
+            state->prev[position & (DEFLATE_WINDOW_SIZE - 1)] = state->head[hash];
+            state->head[hash] = (unsigned int)position + 1;
+
+            if (prevLength < DEFLATE_LAZY_LENGTH) length = micFindDeflateMatch(state, position, prevLength, &distance);
+        }
+
+        if ((prevLength >= 3) && (length <= prevLength))
+        {
+            // Previous position match emitted, its positions added to hash chains
+            state->symbols[state->symbolCount++] = (prevDistance << 16) | (unsigned int)prevLength;
+            state->lengthFreqs[257 + state->lengthCodes[prevLength]]++;
+            state->distanceFreqs[micGetDeflateDistanceCode(state, prevDistance)]++;
+            state->blockLength += prevLength;
+
+            size_t end = position - 1 + prevLength;
+
+            for (position++; position < end; position++)
+            {
+                if ((position + 3) > size) continue;
+
+                unsigned int hash = ((data[position] | (data[position + 1] << 8) | (data[position + 2] << 16))*2654435761u) >> (32 - DEFLATE_HASH_BITS);
+                state->prev[position & (DEFLATE_WINDOW_SIZE - 1)] = state->head[hash];
+                state->head[hash] = (unsigned int)position + 1;
+            }
+
+            prevLength = 0;
+            literalPending = false;
+        }
+        else
+        {
+            if (literalPending)
+            {
+                state->symbols[state->symbolCount++] = data[position - 1];
+                state->lengthFreqs[data[position - 1]]++;
+                state->blockLength++;
+            }
+
+            literalPending = true;
+            prevLength = length;
+            prevDistance = distance;
+            position++;
+        }
+
+        if (state->symbolCount >= (DEFLATE_BLOCK_SYMBOLS - 1)) micWriteDeflateBlock(state, false);
+    }
+
+    if (literalPending)
+    {
+        state->symbols[state->symbolCount++] = data[position - 1];
+        state->lengthFreqs[data[position - 1]]++;
+        state->blockLength++;
+    }
+
+    if (!state->error) micWriteDeflateBlock(state, true);
+    if (!state->error && micReserveDeflateOutput(state, 8)) micFlushDeflateBits(state);
+
+    unsigned char *compData = state->dst;
+    if (state->error)
+    {
+        MIC_FREE(compData);
+        compData = NULL;
+    }
+    else *compSize = state->dstSize;
+
+    MIC_FREE(state->head);
+    MIC_FREE(state->prev);
+    MIC_FREE(state->symbols);
+    MIC_FREE(state);
+
+    return compData;
+}
+
+// Log file: messages, segments rotation and compression
+//----------------------------------------------------------------------------------
+
+// Lock log file sink data
+static inline void micLockLogFile(micLogFile *sink)
+{
+#if defined(_WIN32)
+    AcquireSRWLockExclusive(&sink->lock);
+#else
+    pthread_mutex_lock(&sink->mutex);
+#endif
+}
+
+// Unlock log file sink data
+static inline void micUnlockLogFile(micLogFile *sink)
+{
+#if defined(_WIN32)
+    ReleaseSRWLockExclusive(&sink->lock);
+#else
+    pthread_mutex_unlock(&sink->mutex);
+#endif
+}
+
+// Write message to log file (time stamp, level), segment rotated if its limits are reached
+// NOTE: Called from any thread, messages written by other threads while a segment is rotated are kept in memory
+static void micWriteLogMessage(micLogFile *sink, int logLevel, const char *text, va_list args)
+{
+    static const char *levelNames[] = { "", "TRACE", "DEBUG", "INFO", "WARNING", "ERROR", "FATAL", "" };
+
+    char line[LOG_FILE_LINE_LENGTH] = { 0 };
+    struct timespec now = { 0 };
+    struct tm local = { 0 };
+
+#if defined(_WIN32)
+    timespec_get(&now, TIME_UTC);
+    time_t seconds = now.tv_sec;
+    localtime_s(&local, &seconds);
+#else
+    clock_gettime(CLOCK_REALTIME, &now);
+    time_t seconds = now.tv_sec;
+    localtime_r(&seconds, &local);
+#endif
+
+    int length = snprintf(line, LOG_FILE_LINE_LENGTH, "%04i-%02i-%02i %02i:%02i:%02i.%03i %s: ", local.tm_year + 1900, local.tm_mon + 1, local.tm_mday,
+        local.tm_hour, local.tm_min, local.tm_sec, (int)(now.tv_nsec/1000000), levelNames[((logLevel >= 0) && (logLevel <= MIC_LOG_NONE))? logLevel : 0]);
+    int messageLength = vsnprintf(line + length, LOG_FILE_LINE_LENGTH - length - 1, text, args);
+
+    length += (messageLength < 0)? 0 : (messageLength < (LOG_FILE_LINE_LENGTH - length - 1))? messageLength : (LOG_FILE_LINE_LENGTH - length - 2);
+    line[length++] = '\n';
+
+    bool rotate = false;
+
+    micLockLogFile(sink);
+    bool limitReached = (sink->size > 0) && (((sink->maxSize > 0) && ((sink->size + length) > sink->maxSize)) ||
+        ((sink->maxAge > 0) && (((long long)seconds - sink->openTime) >= sink->maxAge)));
+
+    if (limitReached && sink->threaded)
+    {
+        // Message written into next segment, renames done by background thread
+        // NOTE: Next segment not ready yet (previous renames pending): rotation retried by next messages
+        if (sink->nextFile != NULL)
+        {
+            sink->retiredFile = sink->file;
+            sink->file = sink->nextFile;
+            sink->size = sink->nextSize;
+            sink->openTime = (long long)seconds;
+            sink->nextFile = NULL;
+            sink->renamePending = true;
+        }
+
+        sink->rotateRequested = true;
+#if !defined(_WIN32)
+        pthread_cond_signal(&sink->condition);
+#endif
+    }
+    else if (limitReached && !sink->rotating)
+    {
+        // Message written into new segment
+        sink->rotating = true;
+        rotate = true;
+    }
+
+    if (sink->rotating)
+    {
+        if ((sink->pendingSize + length) > LOG_FILE_PENDING_SIZE) sink->droppedCount++;
+        else
+        {
+            if (sink->pending == NULL) sink->pending = (char *)MIC_MALLOC(LOG_FILE_PENDING_SIZE);
+
+            if (sink->pending != NULL)
+            {
+                memcpy(sink->pending + sink->pendingSize, line, length);
+                sink->pendingSize += length;
+            }
+            else sink->droppedCount++;
+        }
+    }
+    else if (sink->file != NULL)
+    {
+        fwrite(line, 1, length, sink->file);
+        fflush(sink->file);
+        sink->size += length;
+    }
+    micUnlockLogFile(sink);
+
+    // No background thread: segment rotated right away by this thread, compression done after
+    if (rotate) micRotateLogFile(sink);
+}
+
+// Rotate log file: current segment renamed (time stamp suffix), new segment opened, rotated segment compression requested
+// NOTE: Used without background thread, messages written meanwhile are kept in memory, written to new segment once opened
+static void micRotateLogFile(micLogFile *sink)
+{
+    micLockLogFile(sink);
+    FILE *file = sink->file;
+    sink->file = NULL;
+    micUnlockLogFile(sink);
+
+    if (file != NULL) fclose(file);
+
+    bool renamed = micRenameLogSegment(sink->fileName);
+
+    file = fopen(sink->fileName, "ab");
+
+    micLockLogFile(sink);
+    sink->file = file;
+    sink->size = 0;
+    sink->openTime = (long long)time(NULL);
+
+    if (file != NULL)
+    {
+        // Segment not renamed (limits reached again soon): appended
+        if (!renamed && (fseek(file, 0, SEEK_END) == 0)) sink->size = (long long)ftell(file);
+
+        if (sink->pendingSize > 0) fwrite(sink->pending, 1, sink->pendingSize, file);
+        sink->size += (long long)sink->pendingSize;
+        if (sink->droppedCount > 0) sink->size += fprintf(file, "%i log messages dropped while log file was rotated\n", sink->droppedCount);
+        fflush(file);
+    }
+
+    sink->pendingSize = 0;
+    sink->droppedCount = 0;
+    sink->rotating = false;
+
+    bool threaded = sink->threaded;
+
+    if (renamed)
+    {
+        sink->compressRequested = true;
+#if !defined(_WIN32)
+        if (threaded) pthread_cond_signal(&sink->condition);
+#endif
+    }
+    micUnlockLogFile(sink);
+
+    // No background thread, rotated segment compressed by this thread
+    if (renamed && !threaded) micCompressLogFile(sink);
+}
+
+// Rename log file segment with a time stamp suffix, returns true on success
+// NOTE: Time stamp suffix sorts segments by time, counter for segments rotated in the same second
+static bool micRenameLogSegment(const char *fileName)
+{
+    char segmentName[MAX_FILEPATH_LENGTH] = { 0 };
+    char compressedName[MAX_FILEPATH_LENGTH] = { 0 };
+    time_t seconds = time(NULL);
+    struct tm local = { 0 };
+#if defined(_WIN32)
+    localtime_s(&local, &seconds);
+#else
+    localtime_r(&seconds, &local);
+#endif
+
+    for (int counter = 0; counter < 1000; counter++)
+    {
+        if (snprintf(segmentName, MAX_FILEPATH_LENGTH, "%s.%04i%02i%02i-%02i%02i%02i-%03i", fileName, local.tm_year + 1900, local.tm_mon + 1,
+            local.tm_mday, local.tm_hour, local.tm_min, local.tm_sec, counter) >= MAX_FILEPATH_LENGTH) break;
+        if (snprintf(compressedName, MAX_FILEPATH_LENGTH, "%s.gz", segmentName) >= MAX_FILEPATH_LENGTH) break;
+        if (micIsFileAvailable(segmentName) || micIsFileAvailable(compressedName)) continue;
+
+        return (rename(fileName, segmentName) == 0);
+    }
+
+    return false;
+}
+
+// Complete segment switch made by a logging thread (background thread): previous segment closed and renamed
+// (time stamp suffix), current segment renamed from next segment file name to file name, next segment pre-created
+// NOTE: Renames failing are retried on next rotation request, current segment keeps next segment file name meanwhile
+static void micPrepareLogSegments(micLogFile *sink)
+{
+    micLockLogFile(sink);
+    FILE *retiredFile = sink->retiredFile;
+    sink->retiredFile = NULL;
+    sink->rotateRequested = false;
+    bool renamePending = sink->renamePending;
+    bool prepare = (sink->nextFile == NULL) && !sink->closing;
+    micUnlockLogFile(sink);
+
+    if (retiredFile != NULL) fclose(retiredFile);
+
+    if (renamePending)
+    {
+        // Previous segment already renamed when a rename failed before
+        bool renamed = !micIsFileAvailable(sink->fileName) || micRenameLogSegment(sink->fileName);
+        if (renamed) renamed = (rename(sink->nextFileName, sink->fileName) == 0);
+
+        micLockLogFile(sink);
+        if (renamed)
+        {
+            sink->renamePending = false;
+            sink->compressRequested = true;
+        }
+        micUnlockLogFile(sink);
+
+        if (!renamed) prepare = false;
+    }
+
+    if (prepare)
+    {
+        // NOTE: Appended, data left by an interrupted process is kept
+        FILE *file = fopen(sink->nextFileName, "ab");
+        long long size = 0;
+        if ((file != NULL) && (fseek(file, 0, SEEK_END) == 0)) size = (long long)ftell(file);
+
+        micLockLogFile(sink);
+        sink->nextFile = file;
+        sink->nextSize = size;
+        micUnlockLogFile(sink);
+    }
+}
+
+// Check file name is a rotated segment of a log file: base name, time stamp suffix, optional .gz
+static bool micIsLogSegment(const char *name, const char *baseName, bool *compressed)
+{
+    static const char *pattern = "00000000-000000-000";     // Digits positions, time stamp suffix
+
+    size_t baseLength = strlen(baseName);
+    if ((strncmp(name, baseName, baseLength) != 0) || (name[baseLength] != '.')) return false;
+
+    const char *suffix = name + baseLength + 1;
+
+    for (int i = 0; pattern[i] != '\0'; i++)
+    {
+        if ((pattern[i] == '0') && ((suffix[i] < '0') || (suffix[i] > '9'))) return false;
+        if ((pattern[i] == '-') && (suffix[i] != '-')) return false;
+    }
+
+    suffix += strlen(pattern);
+    *compressed = (strcmp(suffix, ".gz") == 0);
+
+    return (*compressed || (suffix[0] == '\0'));
+}
+
+// Compare segments names (oldest first), qsort() callback
+static int micCompareLogSegments(const void *a, const void *b)
+{
+    return strcmp(*(const char **)a, *(const char **)b);
+}
+
+// Compress rotated segment into gzip file (segment removed), returns true on success
+// NOTE: Segment read and compressed by chunks (LOG_FILE_COMPRESS_CHUNK_SIZE), one gzip member per chunk: constant
+// memory whatever the segment size. Compressed into a temporary file renamed once complete, an interrupted compression keeps the segment
+static bool micCompressLogSegment(const char *fileName)
+{
+    char compressedName[MAX_FILEPATH_LENGTH] = { 0 };
+    char tempFileName[MAX_FILEPATH_LENGTH] = { 0 };
+    if (snprintf(compressedName, MAX_FILEPATH_LENGTH, "%s.gz", fileName) >= MAX_FILEPATH_LENGTH) return false;
+    if (snprintf(tempFileName, MAX_FILEPATH_LENGTH, "%s.gz.tmp", fileName) >= MAX_FILEPATH_LENGTH) return false;
+
+    FILE *file = fopen(fileName, "rb");
+    if (file == NULL) return false;
+
+    FILE *compFile = fopen(tempFileName, "wb");
+    unsigned char *data = (unsigned char *)MIC_MALLOC(LOG_FILE_COMPRESS_CHUNK_SIZE);
+    bool success = (compFile != NULL) && (data != NULL);
+    long long totalSize = 0;
+    size_t size = 0;
+
+    do
+    {
+        size = fread(data, 1, LOG_FILE_COMPRESS_CHUNK_SIZE, file);
+        if ((size == 0) && (totalSize > 0)) break;      // Segment size multiple of chunk size (empty segment gets one member)
+
+        size_t compSize = 0;
+        unsigned char *compData = micDeflate(data, size, &compSize);
+        success = (compData != NULL);
+
+        if (success)
+        {
+            // gzip member: header (no name, no time), DEFLATE data, CRC32 and size trailer
+            unsigned int crc = micComputeCrc32(0, data, size);
+            unsigned char header[10] = { 0x1f, 0x8b, 8, 0, 0, 0, 0, 0, 0, 255 };
+            unsigned char trailer[8] = { (unsigned char)crc, (unsigned char)(crc >> 8), (unsigned char)(crc >> 16), (unsigned char)(crc >> 24),
+                (unsigned char)size, (unsigned char)(size >> 8), (unsigned char)(size >> 16), (unsigned char)(size >> 24) };
+
+            success = (fwrite(header, 1, 10, compFile) == 10) && (fwrite(compData, 1, compSize, compFile) == compSize) && (fwrite(trailer, 1, 8, compFile) == 8);
+        }
+
+        MIC_FREE(compData);
+        totalSize += (long long)size;
+
+    } while (success && (size == LOG_FILE_COMPRESS_CHUNK_SIZE));
+
+    if (ferror(file)) success = false;
+    fclose(file);
+    MIC_FREE(data);
+
+    if (compFile != NULL) success = (fclose(compFile) == 0) && success;
+
+#if defined(_WIN32)
+    if (success) success = (MoveFileExA(tempFileName, compressedName, 0x1) != 0);  // MOVEFILE_REPLACE_EXISTING
+#else
+    if (success) success = (rename(tempFileName, compressedName) == 0);
+#endif
+    if (success) remove(fileName);
+    else remove(tempFileName);
+
+    return success;
+}
+
+// Compress rotated segments not compressed yet, delete oldest segments over retention limits (count, total size)
+// NOTE: Segments left by a previous process (not compressed, or compression interrupted) are processed too
+static void micProcessLogSegments(const char *fileName, int maxFiles, long long maxTotalSize)
+{
+    char dirPath[MAX_FILEPATH_LENGTH] = { 0 };
+    const char *baseName = fileName;
+
+    for (const char *ptr = fileName; *ptr != '\0'; ptr++) if (IS_PATH_SEPARATOR(*ptr)) baseName = ptr + 1;
+
+    if (baseName == fileName) strcpy(dirPath, ".");
+    else
+    {
+        size_t length = baseName - fileName - 1;
+        memcpy(dirPath, fileName, (length > 0)? length : 1);
+    }
+
+    int count = 0;
+    char **entries = micLoadDirectoryEntries(dirPath, &count);
+    if (entries == NULL) return;
+
+    const char **segments = (const char **)MIC_MALLOC(((count > 0)? count : 1)*sizeof(const char *));
+    int segmentCount = 0;
+    char path[MAX_FILEPATH_LENGTH] = { 0 };
+
+    for (int i = 0; (segments != NULL) && (i < count); i++)
+    {
+        bool compressed = false;
+        if (!micIsLogSegment(entries[i], baseName, &compressed)) continue;
+
+        // Compressed segments named after the segment, it sorts right after it
+        if (!compressed && (snprintf(path, MAX_FILEPATH_LENGTH, "%s/%s", dirPath, entries[i]) < MAX_FILEPATH_LENGTH)) micCompressLogSegment(path);
+
+        segments[segmentCount++] = entries[i];
+    }
+
+    if (segmentCount > 0)
+    {
+        qsort(segments, segmentCount, sizeof(const char *), micCompareLogSegments);
+
+        long long *sizes = (long long *)MIC_CALLOC(segmentCount, sizeof(long long));
+        long long totalSize = 0;
+
+        for (int i = 0; (sizes != NULL) && (i < segmentCount); i++)
+        {
+            // Segment compressed above: compressed file size
+            struct stat info = { 0 };
+            bool compressed = false;
+            micIsLogSegment(segments[i], baseName, &compressed);
+
+            if ((snprintf(path, MAX_FILEPATH_LENGTH, "%s/%s%s", dirPath, segments[i], compressed? "" : ".gz") < MAX_FILEPATH_LENGTH) && (stat(path, &info) == 0)) sizes[i] = (long long)info.st_size;
+            else if ((snprintf(path, MAX_FILEPATH_LENGTH, "%s/%s", dirPath, segments[i]) < MAX_FILEPATH_LENGTH) && (stat(path, &info) == 0)) sizes[i] = (long long)info.st_size;
+
+            totalSize += sizes[i];
+        }
+
+        // Oldest segments deleted first
+        for (int i = 0, kept = segmentCount; (sizes != NULL) && (i < segmentCount); i++)
+        {
+            if (!(((maxFiles > 0) && (kept > maxFiles)) || ((maxTotalSize > 0) && (totalSize > maxTotalSize)))) break;
+
+            bool compressed = false;
+            micIsLogSegment(segments[i], baseName, &compressed);
+
+            if (snprintf(path, MAX_FILEPATH_LENGTH, "%s/%s", dirPath, segments[i]) < MAX_FILEPATH_LENGTH) remove(path);
+            if (!compressed && (snprintf(path, MAX_FILEPATH_LENGTH, "%s/%s.gz", dirPath, segments[i]) < MAX_FILEPATH_LENGTH)) remove(path);
+
+            totalSize -= sizes[i];
+            kept--;
+        }
+
+        MIC_FREE(sizes);
+    }
+
+    MIC_FREE(segments);
+    micUnloadDirectoryEntries(entries, count);
+}
+
+// Process rotated segments (compression, retention limits) while compression is requested, one thread at a time
+// NOTE: Requests made while another thread is compressing are processed by that thread
+static void micCompressLogFile(micLogFile *sink)
+{
+    micLockLogFile(sink);
+
+    if (!sink->compressing)
+    {
+        sink->compressing = true;
+
+        while (sink->compressRequested)
+        {
+            sink->compressRequested = false;
+            int maxFiles = sink->maxFiles;
+            long long maxTotalSize = sink->maxTotalSize;
+            micUnlockLogFile(sink);
+
+            micProcessLogSegments(sink->fileName, maxFiles, maxTotalSize);
+
+            micLockLogFile(sink);
+        }
+
+        sink->compressing = false;
+    }
+
+    micUnlockLogFile(sink);
+}
+
+// Close log file sink, requested renames and compression completed first
+static void micCloseLogFile(micLogFile *sink)
+{
+#if !defined(_WIN32)
+    if (sink->threaded)
+    {
+        pthread_mutex_lock(&sink->mutex);
+        sink->closing = true;
+        pthread_cond_signal(&sink->condition);
+        pthread_mutex_unlock(&sink->mutex);
+
+        pthread_join(sink->thread, NULL);
+    }
+
+    pthread_mutex_destroy(&sink->mutex);
+    pthread_cond_destroy(&sink->condition);
+#endif
+
+    if (sink->file != NULL) fclose(sink->file);
+    if (sink->retiredFile != NULL) fclose(sink->retiredFile);
+
+    // Next segment not used: removed (unless it contains data left by an interrupted process)
+    if (sink->nextFile != NULL)
+    {
+        fclose(sink->nextFile);
+        if (sink->nextSize == 0) remove(sink->nextFileName);
+    }
+
+    MIC_FREE(sink->pending);
+    MIC_FREE(sink);
+}
+
+#if !defined(_WIN32)
+// Log file background thread: segments renames, rotated segments compression and retention, logging threads never wait for them
+// NOTE: Renames (next segment ready) go before compression, a segment switch requested meanwhile waits for current compression
+static void *micLogFileWorker(void *data)
+{
+    micLogFile *sink = (micLogFile *)data;
+
+    pthread_mutex_lock(&sink->mutex);
+
+    while (true)
+    {
+        while (!sink->rotateRequested && !sink->compressRequested && !sink->closing) pthread_cond_wait(&sink->condition, &sink->mutex);
+
+        if (sink->rotateRequested || (sink->closing && (sink->retiredFile != NULL)))
+        {
+            pthread_mutex_unlock(&sink->mutex);
+            micPrepareLogSegments(sink);
+            pthread_mutex_lock(&sink->mutex);
+        }
+        else if (sink->compressRequested)
+        {
+            pthread_mutex_unlock(&sink->mutex);
+            micCompressLogFile(sink);
+            pthread_mutex_lock(&sink->mutex);
+        }
+        else break;
+    }
+
+    pthread_mutex_unlock(&sink->mutex);
+
+    return NULL;
+}
+#endif
+
 #endif   // MIC_IMPLEMENTATION
@@ -0,0 +1,190 @@
+/*******************************************************************************************
+*
+*   mic bench - DEFLATE decompression throughput, micDecompressData()
+*
+*   Corpus is generated (no external files, deterministic), three kinds of data usually found
+*   in pipelines are measured separately and together:
+*       log:     time stamped log lines, many repeated fields (high compression ratio)
+*       text:    words sequences with punctuation and indentation, like source code or docs
+*       binary:  structured records with random fields, low compression ratio (many literals)
+*
+*   Data is compressed once with micCompressData(), decompression is repeated and the best
+*   time is reported, in MB/s of decompressed data (1 MB = 1000000 bytes)
+*
+*   USAGE:
+*       bench_inflate [corpus size in MB, per kind (default 16)] [repetitions (default 10)]
+*
+*   BUILD:
+*       cc -O2 -o bench_inflate tools/bench_inflate.c -Isrc -lpthread -lm
+*
+*   LICENSE: MIT License
+*
+*   Copyright (c) 2021 Ramon Santamaria (@raysan5)
+*
+********************************************************************************************/
+
+#include <stdbool.h>
+#include <stdarg.h>
+
+#define MIC_IMPLEMENTATION
+#include "mic.h"
+
+//----------------------------------------------------------------------------------
+// Module internal Functions Definition
+//----------------------------------------------------------------------------------
+// Pseudo-random number generator (xorshift32), same corpus on every run and platform
+static unsigned int benchSeed = 0x2545f491;
+
+static unsigned int GetBenchRandom(void)
+{
+    benchSeed ^= benchSeed << 13;
+    benchSeed ^= benchSeed >> 17;
+    benchSeed ^= benchSeed << 5;
+
+    return benchSeed;
+}
+
+// Generate time stamped log lines
+static int GenerateLogCorpus(char *data, int size)
+{
+    static const char *levels[] = { "INFO", "INFO", "INFO", "DEBUG", "WARNING", "ERROR" };
+    static const char *actions[] = { "Command finished", "File copied", "Directory created", "Step finished", "File hashed" };
+    int length = 0;
+
+    for (int i = 0; length < (size - 256); i++)
+    {
+        unsigned int value = GetBenchRandom();
+
+        length += sprintf(data + length, "2026-10-19 %02i:%02i:%02i.%03i %s: [build/module%02u/file%03u.c] %s in %u.%02u ms (exit code %u)\n",
+            (i/3600000)%24, (i/60000)%60, (i/1000)%60, i%1000, levels[value%6], (value >> 3)%40, (value >> 9)%500,
+            actions[(value >> 18)%5], (value >> 21)%2000, (value >> 11)%100, ((value >> 28) == 0)? 1 : 0);
+    }
+
+    return length;
+}
+
+// Generate words sequences with punctuation and indentation
+static int GenerateTextCorpus(char *data, int size)
+{
+    static const char *words[] = {
+        "the", "data", "file", "is", "to", "of", "a", "in", "and", "for", "return", "if", "else", "while", "size",
+        "length", "buffer", "count", "state", "int", "char", "const", "static", "void", "bool", "NULL", "index",
+        "path", "result", "value", "micLoadFileData", "micTraceLog", "context", "thread", "segment", "compressed" };
+    static const char *separators[] = { " ", " ", " ", " ", ", ", "; ", "(", ")", " = ", " == ", "->", "." };
+    int length = 0;
+
+    while (length < (size - 256))
+    {
+        unsigned int value = GetBenchRandom();
+        int indent = (value%4)*4;
+        int wordCount = 3 + (value >> 2)%12;
+
+        memset(data + length, ' ', indent);
+        length += indent;
+
+        for (int i = 0; i < wordCount; i++)
+        {
+            value = GetBenchRandom();
+            length += sprintf(data + length, "%s%s", words[value%36], (i < (wordCount - 1))? separators[(value >> 8)%12] : "\n");
+        }
+    }
+
+    return length;
+}
+
+// Generate structured records with random fields
+static int GenerateBinaryCorpus(unsigned char *data, int size)
+{
+    int length = 0;
+
+    while (length < (size - 32))
+    {
+        unsigned int value = GetBenchRandom();
+
+        // Record: type, flags, small counter, random id and payload
+        data[length++] = 0x10 + (value%4);
+        data[length++] = 0;
+        data[length] = (unsigned char)(length >> 5);
+        length++;
+        data[length++] = (unsigned char)(value >> 8)%16;
+
+        for (int i = 0; i < 3; i++)
+        {
+            value = GetBenchRandom();
+            memcpy(data + length, &value, 4);
+            length += 4;
+        }
+
+        for (int i = 0; i < 12; i++) data[length++] = ((GetBenchRandom()%3) == 0)? (unsigned char)GetBenchRandom() : 0;
+    }
+
+    return length;
+}
+
+// Measure decompression of data, returns throughput in MB/s (best time), 0 on failure
+static double MeasureInflate(const char *name, unsigned char *data, int size, int repetitions)
+{
+    int compSize = 0;
+    unsigned char *compData = micCompressData(data, size, &compSize);
+
+    if (compData == NULL)
+    {
+        printf("%-8s compression failed\n", name);
+        return 0.0;
+    }
+
+    double bestTime = 0.0;
+    bool valid = true;
+
+    for (int i = 0; (i < repetitions) && valid; i++)
+    {
+        int decompSize = 0;
+        double startTime = micGetTime();
+        unsigned char *decompData = micDecompressData(compData, compSize, &decompSize);
+        double time = micGetTime() - startTime;
+
+        valid = (decompData != NULL) && (decompSize == size) && (memcmp(decompData, data, size) == 0);
+        if ((i == 0) || (time < bestTime)) bestTime = time;
+
+        MIC_FREE(decompData);
+    }
+
+    MIC_FREE(compData);
+
+    double throughput = valid? (double)size/1000000.0/(bestTime/1000.0) : 0.0;
+
+    if (valid) printf("%-8s %10i -> %10i bytes (%5.1f%%)  %8.2f ms  %8.1f MB/s\n", name, size, compSize, 100.0*compSize/size, bestTime, throughput);
+    else printf("%-8s decompressed data does not match\n", name);
+
+    return throughput;
+}
+
+//------------------------------------------------------------------------------------
+// Program main entry point
+//------------------------------------------------------------------------------------
+int main(int argc, char *argv[])
+{
+    int corpusSize = ((argc > 1) && (atoi(argv[1]) > 0))? atoi(argv[1])*1000000 : 16*1000000;
+    int repetitions = ((argc > 2) && (atoi(argv[2]) > 0))? atoi(argv[2]) : 10;
+
+    micSetTraceLogLevel(MIC_LOG_WARNING);
+    micInitTimer();
+
+    unsigned char *data = (unsigned char *)MIC_MALLOC(3*(size_t)corpusSize);
+    if (data == NULL) return 1;
+
+    int logSize = GenerateLogCorpus((char *)data, corpusSize);
+    int textSize = GenerateTextCorpus((char *)data + logSize, corpusSize);
+    int binarySize = GenerateBinaryCorpus(data + logSize + textSize, corpusSize);
+
+    printf("DEFLATE decompression throughput, %i repetitions (best time)\n", repetitions);
+
+    bool valid = (MeasureInflate("log", data, logSize, repetitions) > 0.0);
+    valid = (MeasureInflate("text", data + logSize, textSize, repetitions) > 0.0) && valid;
+    valid = (MeasureInflate("binary", data + logSize + textSize, binarySize, repetitions) > 0.0) && valid;
+    valid = (MeasureInflate("all", data, logSize + textSize + binarySize, repetitions) > 0.0) && valid;
+
+    MIC_FREE(data);
+
+    return valid? 0 : 1;
+}
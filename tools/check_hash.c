@@ -0,0 +1,85 @@
+/*******************************************************************************************
+*
+*   mic check - Hash known answers, micHashData()
+*
+*   Digests of generated inputs (byte i is i%251) are compared with the ones computed by
+*   reference implementations, inputs cover all XXH3 length classes and big inputs hashed
+*   on multiple threads (BLAKE3) or in many blocks (XXH3)
+*
+*   USAGE:
+*       check_hash (returns 0 if all digests match)
+*
+*   BUILD:
+*       cc -O2 -o check_hash tools/check_hash.c -Isrc -lpthread -lm
+*
+*   LICENSE: MIT License
+*
+*   Copyright (c) 2021 Ramon Santamaria (@raysan5)
+*
+********************************************************************************************/
+
+#include <stdbool.h>
+#include <stdarg.h>
+
+#define MIC_IMPLEMENTATION
+#include "mic.h"
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+// Known answer: hash type, input size and expected digest (hexadecimal)
+typedef struct KnownAnswer {
+    int type;
+    long long size;
+    const char *digest;
+} KnownAnswer;
+
+//------------------------------------------------------------------------------------
+// Program main entry point
+//------------------------------------------------------------------------------------
+int main(void)
+{
+    // NOTE: XXH3 digests from reference xxHash (XXH3_64bits(), seed 0), BLAKE3 from specification
+    static const KnownAnswer answers[] = {
+        { MIC_HASH_XXH3, 0, "2d06800538d394c2" },
+        { MIC_HASH_XXH3, 3, "5f4299fc161c9cbb" },
+        { MIC_HASH_XXH3, 100, "004e4f921a64bd1c" },
+        { MIC_HASH_XXH3, 200, "f42a8864feaf0703" },
+        { MIC_HASH_XXH3, 1000, "33ef703fb2b20ed1" },
+        { MIC_HASH_XXH3, 4*1024*1024, "e747d2a342fb4555" },
+        { MIC_HASH_XXH3, 4*1024*1024 + 1, "101c2cdd9b96e8e8" },
+        { MIC_HASH_XXH3, 10*1024*1024 + 17, "5ba436cd7f2e61c8" },
+        { MIC_HASH_BLAKE3, 0, "af1349b9f5f9a1a6a0404dea36dcc9499bcb25c9adc112b7cc9a93cae41f3262" },
+    };
+
+    micSetTraceLogLevel(MIC_LOG_WARNING);
+
+    const int answerCount = sizeof(answers)/sizeof(answers[0]);
+    long long maxSize = 0;
+    for (int i = 0; i < answerCount; i++) if (answers[i].size > maxSize) maxSize = answers[i].size;
+
+    unsigned char *data = (unsigned char *)MIC_MALLOC((size_t)maxSize);
+    if (data == NULL) return 1;
+
+    for (long long i = 0; i < maxSize; i++) data[i] = (unsigned char)(i%251);
+
+    int failed = 0;
+
+    for (int i = 0; i < answerCount; i++)
+    {
+        micHash hash = micHashData(data, answers[i].size, answers[i].type);
+        const char *digest = micHashToString(hash);
+        bool valid = (strcmp(digest, answers[i].digest) == 0);
+
+        printf("%-6s %10lli bytes: %s %s\n", (answers[i].type == MIC_HASH_XXH3)? "XXH3" : "BLAKE3", answers[i].size, digest, valid? "OK" : "FAILED");
+        if (!valid)
+        {
+            printf("    expected: %s\n", answers[i].digest);
+            failed++;
+        }
+    }
+
+    MIC_FREE(data);
+
+    return (failed == 0)? 0 : 1;
+}